@@ -5,9 +5,109 @@
 #include <iostream>
 #include <algorithm>
 #include <unordered_set>
+#include <queue>
+#include <limits>
+#include <cstdlib>
 
 using namespace std;
 
+// Struct to hold a day's place in the slot queue
+struct SlotPriority {
+    int exercises;      // Exercises already on the day
+    double headroom;    // Minutes left under MAX_TIME_PER_DAY
+    int day;
+};
+
+// Order for the slot queue: days with fewer exercises first, then the more time headroom, then
+// the earlier day. Earlier days go first among equals because candidates are scored against the
+// previous day's load.
+struct SlotOrder {
+    bool operator()(const SlotPriority& a, const SlotPriority& b) const {
+        if (a.exercises != b.exercises) return a.exercises > b.exercises;
+        if (a.headroom != b.headroom) return a.headroom < b.headroom;
+        return a.day > b.day;
+    }
+};
+
+// Function to check a muscle's recovery against every day it is already worked, before or after
+// the given day; days are filled out of order, so a last-worked day is not enough
+static bool recovered_around(const string& muscle, int day, const unordered_map<string, unsigned>& worked_days) {
+    auto it = worked_days.find(muscle);
+    if (it == worked_days.end()) return true;
+    int required_gap = muscle_recovery_days.at(muscle);
+    for (int other = 0; other < 32; ++other) {
+        if ((it->second >> other & 1u) && abs(day - other) < required_gap) return false;
+    }
+    return true;
+}
+
+// Function to record the days an exercise works each muscle that has a recovery time
+static void mark_worked(const string& exercise, int day, const unordered_map<string, unordered_map<string, double>>& exercise_contributions,
+                        unordered_map<string, unsigned>& worked_days) {
+    for (const auto& [muscle, contrib] : exercise_contributions.at(exercise)) {
+        if (muscle_recovery_days.find(muscle) != muscle_recovery_days.end()) worked_days[muscle] |= 1u << day;
+    }
+}
+
+// Function to score an isolation candidate for a slot (lower is better): volume toward the
+// targets, penalized by load on muscles worked the previous day and by repeat use. Returns false when one
+// of its muscles is worked too close to the day.
+static bool score_slot_candidate(const string& ex, int day,
+                                 const unordered_map<string, double>& prev_day_coverage,
+                                 const unordered_map<string, double>& current_volume,
+                                 const unordered_map<string, unsigned>& worked_days,
+                                 const unordered_map<string, int>& exercise_usage,
+                                 const unordered_map<string, double>& target_coverage,
+                                 const unordered_map<string, Exercise>& exercises_map,
+                                 double& score) {
+    const Exercise& exercise = exercises_map.at(ex);
+    unordered_set<string> exercise_muscles;
+    unordered_set<string> primary_muscles;
+    for (const auto& muscle : exercise.primary) {
+        exercise_muscles.insert(muscle);
+        primary_muscles.insert(muscle);
+        if (!recovered_around(muscle, day, worked_days)) return false;
+    }
+    for (const auto& muscle : exercise.secondary) {
+        exercise_muscles.insert(muscle);
+        if (!recovered_around(muscle, day, worked_days)) return false;
+    }
+    for (const auto& muscle : exercise.isometric) {
+        exercise_muscles.insert(muscle);
+        if (!recovered_around(muscle, day, worked_days)) return false;
+    }
+
+    double recovery_penalty = 0;
+    for (const auto& muscle : exercise_muscles) {
+        auto it = prev_day_coverage.find(muscle);
+        double prev_workload = it != prev_day_coverage.end() ? it->second : 0.0;
+        if (primary_muscles.count(muscle)) {
+            recovery_penalty += prev_workload * 25;
+        } else {
+            recovery_penalty += prev_workload * 0.25 * 5;
+        }
+    }
+    double volume_score = 0;
+    auto matches = [](const vector<string>& muscles, const string& muscle) {
+        for (const auto& m : muscles) {
+            if (m.substr(0, m.find(" (")) == muscle) return true;
+        }
+        return false;
+    };
+    for (const auto& [muscle, target] : target_coverage) {
+        auto it = current_volume.find(muscle);
+        double diff = target - (it != current_volume.end() ? it->second : 0.0);
+        if (diff <= 0) continue;
+        double contribution = (matches(exercise.primary, muscle) ? 1.0 : 0.0) +
+                              (matches(exercise.secondary, muscle) ? 0.25 : 0.0) +
+                              (matches(exercise.isometric, muscle) ? 0.25 : 0.0);
+        volume_score -= diff * contribution * 200;  // Heavily prioritize volume
+    }
+    auto usage = exercise_usage.find(ex);
+    score = volume_score + recovery_penalty + (usage != exercise_usage.end() ? usage->second : 0) * 10;
+    return true;
+}
+
 void assign_exercises(
     unordered_map<int, vector<string>>& days,
     unordered_map<string, int>& exercise_usage,
@@ -299,11 +399,42 @@ void assign_exercises(
         }
     }
 
-    int day_index = 1;
+    // Fill the remaining slots from a priority queue of days: a day leaves the queue when it is
+    // full or has no eligible candidate left, so every pop fills a slot or retires a day.
+    // Candidates per day are kept incrementally (not yet on the day, and no second leg exercise).
+    vector<vector<string>> eligible(total_days + 1);
+    for (int day = 1; day <= total_days; ++day) {
+        bool has_leg = false;  // check_leg_exercise_constraint allows one leg exercise per day
+        for (const auto& exercise : days[day]) has_leg = has_leg || exercises_map.at(exercise).is_leg;
+        for (const auto& ex : available_exercises) {
+            if (find(days[day].begin(), days[day].end(), ex) != days[day].end()) continue;
+            if (has_leg && exercises_map.at(ex).is_leg) continue;
+            eligible[day].push_back(ex);
+        }
+    }
+    int unused_exercises = 0;
+    for (const auto& ex : exercises) {
+        if (exercise_usage[ex.name] == 0) ++unused_exercises;
+    }
+    auto current_volume = calculate_volume(routine, exercises_map);  // The routine is built after assignment
+    unordered_map<string, unsigned> worked_days;  // Bit d set when the muscle is worked on day d
+    for (int day = 1; day <= total_days; ++day) {
+        for (const auto& exercise : days[day]) mark_worked(exercise, day, exercise_contributions, worked_days);
+    }
+    priority_queue<SlotPriority, vector<SlotPriority>, SlotOrder> slot_queue;
+    auto queue_day = [&](int day) {
+        if (days[day].size() >= static_cast<size_t>(target_exercises_per_day) + 1) {
+            cout << "  Day " << day << " now has " << days[day].size() << " exercises and is full.\n";
+            return;
+        }
+        slot_queue.push({static_cast<int>(days[day].size()), MAX_TIME_PER_DAY - day_times[day], day});
+    };
+    for (int day = 1; day <= total_days; ++day) queue_day(day);
+
     int slots_filled = 0;
-    vector<tuple<int, vector<string>, int>> deferred_slots;
-    while (slots_filled < remaining_slots) {
-        int day = day_index;
+    while (slots_filled < remaining_slots && !slot_queue.empty()) {
+        int day = slot_queue.top().day;
+        slot_queue.pop();
         vector<string>& current_exercises = days[day];
         int current_leg_exercises = 0;
         for (const auto& ex : current_exercises) {
@@ -312,321 +443,61 @@ void assign_exercises(
         cout << "\nAttempting to fill a slot on Day " << day << ": " << current_exercises.size()
              << " exercises (leg exercises: " << current_leg_exercises << ", current time: "
              << day_times[day] << " minutes), target: " << target_exercises_per_day << "\n";
-        if (current_exercises.size() >= target_exercises_per_day + 1) {
-            cout << "  Day " << day << " already has " << current_exercises.size() << " exercises, skipping.\n";
-            day_index = (day_index % total_days) + 1;
+        if (eligible[day].empty()) {
+            cout << "  No eligible exercises for Day " << day << ". Leaving the slot empty.\n";
             continue;
         }
 
-        vector<string> available_for_day;
-        for (const auto& ex : available_exercises) {
-            if (find(current_exercises.begin(), current_exercises.end(), ex) == current_exercises.end()) {
-                available_for_day.push_back(ex);
-            }
-        }
-        if (available_for_day.empty()) {
-            cout << "  No available exercises for Day " << day << " (all exercises already used in this day). Deferring slot.\n";
-            deferred_slots.emplace_back(day, current_exercises, current_leg_exercises);
-            day_index = (day_index % total_days) + 1;
-            continue;
-        }
-
-        bool all_used = true;
-        for (const auto& ex : exercises) {
-            if (exercise_usage[ex.name] == 0) {
-                all_used = false;
-                break;
-            }
-        }
-        vector<string> candidates = all_used ? available_for_day : vector<string>();
-        if (!all_used) {
-            for (const auto& ex : available_for_day) {
+        vector<string> candidates;
+        if (unused_exercises > 0) {
+            for (const auto& ex : eligible[day]) {
                 if (exercise_usage[ex] == 0) candidates.push_back(ex);
             }
         }
-        if (candidates.empty()) candidates = available_for_day;
+        if (candidates.empty()) candidates = eligible[day];
 
-        string exercise;
         double best_score = numeric_limits<double>::max();
-        string best_exercise;
+        string exercise;
         unordered_map<string, double> prev_day_coverage = day > 1 ? calculate_day_coverage(days[day-1], exercise_contributions) : unordered_map<string, double>();
-        auto current_volume = calculate_volume(routine, exercises_map);
-        for (size_t i = 0; i < candidates.size(); ++i) {
-            const auto& ex = candidates[i];
-            bool can_use = true;
-            unordered_set<string> exercise_muscles;
-            unordered_set<string> primary_muscles;
-            for (const auto& muscle : exercises_map.at(ex).primary) {
-                exercise_muscles.insert(muscle);
-                primary_muscles.insert(muscle);
-                if (!can_work_muscle(muscle, day, last_worked_day)) {
-                    can_use = false;
-                    break;
-                }
-            }
-            for (const auto& muscle : exercises_map.at(ex).secondary) {
-                exercise_muscles.insert(muscle);
-                if (!can_work_muscle(muscle, day, last_worked_day)) {
-                    can_use = false;
-                    break;
-                }
-            }
-            for (const auto& muscle : exercises_map.at(ex).isometric) {
-                exercise_muscles.insert(muscle);
-                if (!can_work_muscle(muscle, day, last_worked_day)) {
-                    can_use = false;
-                    break;
-                }
-            }
-            if (!can_use) continue;
-
-            unordered_map<string, double> temp_coverage = muscle_coverage;
-            double temp_time = day_times[day];
-            for (const auto& [muscle, contrib] : exercise_contributions.at(ex)) {
-                temp_coverage[muscle] += contrib * 3;
-            }
-            temp_time += calculate_time({ex}, 3);
-            double recovery_penalty = 0;
-            for (const auto& muscle : exercise_muscles) {
-                double prev_workload = prev_day_coverage[muscle];
-                double penalty = prev_workload * (primary_muscles.count(muscle) ? 1.0 : 0.25);
-                if (primary_muscles.count(muscle)) {
-                    recovery_penalty += penalty * 25;
-                } else {
-                    recovery_penalty += penalty * 5;
-                }
-            }
-            double volume_score = 0;
-            for (const auto& [muscle, target] : target_coverage) {
-                double current = current_volume[muscle];
-                double diff = target - current;
-                if (diff > 0) {
-                    bool contributes = false;
-                    double contribution = 0;
-                    for (const auto& m : exercises_map.at(ex).primary) {
-                        string base_muscle = m.substr(0, m.find(" ("));
-                        if (base_muscle == muscle) {
-                            contributes = true;
-                            contribution += 1.0;
-                            break;
-                        }
-                    }
-                    for (const auto& m : exercises_map.at(ex).secondary) {
-                        string base_muscle = m.substr(0, m.find(" ("));
-                        if (base_muscle == muscle) {
-                            contributes = true;
-                            contribution += 0.25;
-                            break;
-                        }
-                    }
-                    for (const auto& m : exercises_map.at(ex).isometric) {
-                        string base_muscle = m.substr(0, m.find(" ("));
-                        if (base_muscle == muscle) {
-                            contributes = true;
-                            contribution += 0.25;
-                            break;
-                        }
-                    }
-                    if (contributes) {
-                        volume_score -= diff * contribution * 200;  // Heavily prioritize volume
-                    }
-                }
-            }
-            double usage_score = exercise_usage[ex] * 10;  // Further reduced penalty
-            double score = volume_score + recovery_penalty + usage_score;
+        for (const auto& ex : candidates) {
+            double score;
+            if (!score_slot_candidate(ex, day, prev_day_coverage, current_volume, worked_days, exercise_usage,
+                                      target_coverage, exercises_map, score)) continue;
             if (score < best_score) {
                 best_score = score;
-                best_exercise = ex;
-            }
-        }
-        if (!best_exercise.empty()) {
-            exercise = best_exercise;
-        } else {
-            // Fallback: relax recovery constraints and pick any exercise
-            for (const auto& ex : available_for_day) {
                 exercise = ex;
-                break;
-            }
-        }
-        // Ensure an exercise was selected and is not already in the day's list
-        if (exercise.empty()) {
-            // Last resort: pick any available exercise, ignoring all constraints except duplicates
-            for (const auto& ex : available_exercises) {
-                if (find(current_exercises.begin(), current_exercises.end(), ex) == current_exercises.end()) {
-                    exercise = ex;
-                    break;
-                }
             }
         }
+        if (exercise.empty()) exercise = eligible[day][0];  // Fallback: relax recovery constraints
         cout << "  Selected exercise: " << exercise << " (is_leg: " << exercises_map.at(exercise).is_leg
              << ", usage: " << exercise_usage[exercise] << ")\n";
-        vector<string> temp_exercises = current_exercises;
-        temp_exercises.push_back(exercise);
-        vector<vector<string>> temp_structures;
-        for (const auto& ex : temp_exercises) temp_structures.push_back({ex});
-        if (check_leg_exercise_constraint(temp_structures, exercises_map)) {
-            days[day].push_back(exercise);
-            ++exercise_usage[exercise];
-            for (const auto& [muscle, contrib] : exercise_contributions.at(exercise)) {
-                muscle_coverage[muscle] += contrib * 3;
-                if (muscle_recovery_days.find(muscle) != muscle_recovery_days.end()) {
-                    last_worked_day[muscle] = day;
-                    string base_muscle = muscle.substr(0, muscle.find(" ("));
-                    muscle_days_worked[base_muscle]++;
-                }
-            }
-            day_times[day] += calculate_time({exercise}, 3);
-            ++slots_filled;
-            cout << "  Assigned " << exercise << " to Day " << day << ". Day " << day << " now has "
-                 << temp_exercises.size() << " exercises (leg exercises: "
-                 << (current_leg_exercises + (exercises_map.at(exercise).is_leg ? 1 : 0))
-                 << ", new usage: " << exercise_usage[exercise] << ", new time: "
-                 << day_times[day] << " minutes)\n";
-        } else {
-            cout << "  Cannot assign " << exercise << " to Day " << day << ": violates leg exercise constraint. Deferring slot.\n";
-            deferred_slots.emplace_back(day, current_exercises, current_leg_exercises);
-        }
-        day_index = (day_index % total_days) + 1;
-    }
-
-    // Handle deferred slots, prioritizing under-volume muscle groups
-    if (!deferred_slots.empty()) {
-        cout << "\nHandling deferred slots: " << deferred_slots.size() << " slots\n";
-        // Calculate volume outside the lambda to capture it properly
-        auto current_volume = calculate_volume(routine, exercises_map);
-        // Sort deferred slots by the largest volume deficit of associated muscle groups
-        sort(deferred_slots.begin(), deferred_slots.end(), 
-             [&current_volume, &target_coverage](const auto& a, const auto& b) {
-                 double max_deficit_a = 0;
-                 double max_deficit_b = 0;
-                 for (const auto& [muscle, target] : target_coverage) {
-                     double deficit_a = target - current_volume[muscle];
-                     double deficit_b = target - current_volume[muscle];
-                     if (deficit_a > max_deficit_a) max_deficit_a = deficit_a;
-                     if (deficit_b > max_deficit_b) max_deficit_b = deficit_b;
-                 }
-                 return max_deficit_a > max_deficit_b;
-             });
-
-        for (const auto& [day, current_exercises, current_leg_exercises] : deferred_slots) {
-            if (current_exercises.size() >= target_exercises_per_day) continue;
-            vector<string> non_leg_exercises;
-            for (const auto& ex : available_exercises) {
-                if (!exercises_map.at(ex).is_leg && find(current_exercises.begin(), current_exercises.end(), ex) == current_exercises.end()) {
-                    non_leg_exercises.push_back(ex);
-                }
-            }
-            if (!non_leg_exercises.empty()) {
-                double best_score = numeric_limits<double>::max();
-                string best_exercise;
-                unordered_map<string, double> prev_day_coverage = day > 1 ? calculate_day_coverage(days[day-1], exercise_contributions) : unordered_map<string, double>();
-                auto current_volume = calculate_volume(routine, exercises_map);
-                for (const auto& ex : non_leg_exercises) {
-                    bool can_use = true;
-                    unordered_set<string> exercise_muscles;
-                    unordered_set<string> primary_muscles;
-                    for (const auto& muscle : exercises_map.at(ex).primary) {
-                        exercise_muscles.insert(muscle);
-                        primary_muscles.insert(muscle);
-                        if (!can_work_muscle(muscle, day, last_worked_day)) {
-                            can_use = false;
-                            break;
-                        }
-                    }
-                    for (const auto& muscle : exercises_map.at(ex).secondary) {
-                        exercise_muscles.insert(muscle);
-                        if (!can_work_muscle(muscle, day, last_worked_day)) {
-                            can_use = false;
-                            break;
-                        }
-                    }
-                    for (const auto& muscle : exercises_map.at(ex).isometric) {
-                        exercise_muscles.insert(muscle);
-                        if (!can_work_muscle(muscle, day, last_worked_day)) {
-                            can_use = false;
-                            break;
-                        }
-                    }
-                    if (!can_use) continue;
 
-                    unordered_map<string, double> temp_coverage = muscle_coverage;
-                    for (const auto& [muscle, contrib] : exercise_contributions.at(ex)) {
-                        temp_coverage[muscle] += contrib * 3;
-                    }
-                    double recovery_penalty = 0;
-                    for (const auto& muscle : exercise_muscles) {
-                        double prev_workload = prev_day_coverage[muscle];
-                        double penalty = prev_workload * (primary_muscles.count(muscle) ? 1.0 : 0.25);
-                        if (primary_muscles.count(muscle)) {
-                            recovery_penalty += penalty * 25;
-                        } else {
-                            recovery_penalty += penalty * 5;
-                        }
-                    }
-                    double volume_score = 0;
-                    for (const auto& [muscle, target] : target_coverage) {
-                        double current = current_volume[muscle];
-                        double diff = target - current;
-                        if (diff > 0) {
-                            bool contributes = false;
-                            double contribution = 0;
-                            for (const auto& m : exercises_map.at(ex).primary) {
-                                string base_muscle = m.substr(0, m.find(" ("));
-                                if (base_muscle == muscle) {
-                                    contributes = true;
-                                    contribution += 1.0;
-                                    break;
-                                }
-                            }
-                            for (const auto& m : exercises_map.at(ex).secondary) {
-                                string base_muscle = m.substr(0, m.find(" ("));
-                                if (base_muscle == muscle) {
-                                    contributes = true;
-                                    contribution += 0.25;
-                                    break;
-                                }
-                            }
-                            for (const auto& m : exercises_map.at(ex).isometric) {
-                                string base_muscle = m.substr(0, m.find(" ("));
-                                if (base_muscle == muscle) {
-                                    contributes = true;
-                                    contribution += 0.25;
-                                    break;
-                                }
-                            }
-                            if (contributes) {
-                                volume_score -= diff * contribution * 200;
-                            }
-                        }
-                    }
-                    double usage_score = exercise_usage[ex] * 10;
-                    double score = volume_score + recovery_penalty + usage_score;
-                    if (score < best_score) {
-                        best_score = score;
-                        best_exercise = ex;
-                    }
-                }
-                string exercise;
-                if (!best_exercise.empty()) {
-                    exercise = best_exercise;
-                } else {
-                    // Fallback: pick any non-leg exercise
-                    exercise = non_leg_exercises[0];
-                }
-                days[day].push_back(exercise);
-                ++exercise_usage[exercise];
-                for (const auto& [muscle, contrib] : exercise_contributions.at(exercise)) {
-                    muscle_coverage[muscle] += contrib * 3;
-                    if (muscle_recovery_days.find(muscle) != muscle_recovery_days.end()) {
-                        last_worked_day[muscle] = day;
-                        string base_muscle = muscle.substr(0, muscle.find(" ("));
-                        muscle_days_worked[base_muscle]++;
-                    }
-                }
-                day_times[day] += calculate_time({exercise}, 3);
-                cout << "    Assigned non-leg exercise " << exercise << " to Day " << day << ".\n";
+        current_exercises.push_back(exercise);
+        if (exercise_usage[exercise]++ == 0) --unused_exercises;
+        for (const auto& [muscle, contrib] : exercise_contributions.at(exercise)) {
+            muscle_coverage[muscle] += contrib * 3;
+            if (muscle_recovery_days.find(muscle) != muscle_recovery_days.end()) {
+                last_worked_day[muscle] = max(last_worked_day[muscle], day);
+                string base_muscle = muscle.substr(0, muscle.find(" ("));
+                muscle_days_worked[base_muscle]++;
             }
         }
+        mark_worked(exercise, day, exercise_contributions, worked_days);
+        day_times[day] += calculate_time({exercise}, 3);
+        ++slots_filled;
+        bool is_leg = exercises_map.at(exercise).is_leg;
+        eligible[day].erase(remove_if(eligible[day].begin(), eligible[day].end(), [&](const string& ex) {
+            return ex == exercise || (is_leg && exercises_map.at(ex).is_leg);
+        }), eligible[day].end());
+        cout << "  Assigned " << exercise << " to Day " << day << ". Day " << day << " now has "
+             << current_exercises.size() << " exercises (leg exercises: "
+             << (current_leg_exercises + (is_leg ? 1 : 0))
+             << ", new usage: " << exercise_usage[exercise] << ", new time: "
+             << day_times[day] << " minutes)\n";
+        queue_day(day);
+    }
+    if (slots_filled < remaining_slots) {
+        cout << "\nEvery day is full or out of candidates with " << remaining_slots - slots_filled << " slots unfilled.\n";
     }
 
     // Print final assignment and usage counts
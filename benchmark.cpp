@@ -0,0 +1,153 @@
+#include "benchmark.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <tuple>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+
+using namespace std;
+
+// Function to write one row per run
+bool write_runs_csv(const vector<BenchmarkRun>& runs, const string& filename) {
+    ofstream out(filename);
+    if (!out) {
+        cerr << "Error opening file " << filename << endl;
+        return false;
+    }
+    out << setprecision(10);
+    out << "engine,profile,metric,seed,budget,cost,violations,seconds\n";
+    for (const auto& run : runs) {
+        out << run.engine << "," << run.profile << "," << run.metric << "," << run.seed << "," << run.budget << ","
+            << run.cost << "," << run.violations << "," << run.seconds << "\n";
+    }
+    return true;
+}
+
+// Function to write time-to-target curves. A profile's targets sit the given gaps above the best
+// final cost any engine reached on it (within one metric). For each engine, budget, profile and
+// gap, the curve is the fraction of its runs (over seeds) whose best cost had reached the target
+// by each time; runs that never reach it keep the curve below 1.
+bool write_curves_csv(const vector<BenchmarkRun>& runs, const vector<double>& gaps, const string& filename) {
+    ofstream out(filename);
+    if (!out) {
+        cerr << "Error opening file " << filename << endl;
+        return false;
+    }
+    map<pair<string, string>, double> best_known;
+    for (const auto& run : runs) {
+        auto key = make_pair(run.profile, run.metric);
+        if (!best_known.count(key) || run.cost < best_known[key]) best_known[key] = run.cost;
+    }
+    map<tuple<string, double, string, string>, vector<const BenchmarkRun*>> groups;
+    for (const auto& run : runs) groups[make_tuple(run.engine, run.budget, run.profile, run.metric)].push_back(&run);
+
+    out << setprecision(10);
+    out << "engine,budget,profile,gap,target,seconds,fraction\n";
+    for (const auto& [key, group] : groups) {
+        const auto& [engine, budget, profile, metric] = key;
+        for (double gap : gaps) {
+            double target = best_known[make_pair(profile, metric)] * (1.0 + gap);
+            vector<double> reached;
+            for (const BenchmarkRun* run : group) {
+                for (const auto& point : run->curve) {
+                    if (point.best_cost <= target) {
+                        reached.push_back(point.seconds);
+                        break;
+                    }
+                }
+            }
+            sort(reached.begin(), reached.end());
+            for (size_t i = 0; i < reached.size(); ++i) {
+                out << engine << "," << budget << "," << profile << "," << gap << "," << target << ","
+                    << reached[i] << "," << static_cast<double>(i + 1) / group.size() << "\n";
+            }
+        }
+    }
+    return true;
+}
+
+// Function to print mean cost, violations and wall time per engine, budget and profile
+void print_summary(const vector<BenchmarkRun>& runs) {
+    struct Totals {
+        int runs = 0;
+        double cost = 0.0;
+        double violations = 0.0;
+        double seconds = 0.0;
+    };
+    map<tuple<string, string, double>, Totals> totals;
+    for (const auto& run : runs) {
+        Totals& t = totals[make_tuple(run.profile, run.engine, run.budget)];
+        ++t.runs;
+        t.cost += run.cost;
+        t.violations += run.violations;
+        t.seconds += run.seconds;
+    }
+    cout << left << setw(24) << "profile" << setw(18) << "engine" << right << setw(10) << "budget s" << setw(14) << "mean cost"
+         << setw(12) << "violations" << setw(12) << "seconds" << "\n";
+    for (const auto& [key, t] : totals) {
+        const auto& [profile, engine, budget] = key;
+        cout << left << setw(24) << profile << setw(18) << engine << right << fixed << setprecision(3) << setw(10) << budget
+             << setprecision(1) << setw(14) << t.cost / t.runs << setprecision(2) << setw(12) << t.violations / t.runs
+             << setprecision(3) << setw(12) << t.seconds / t.runs << "\n";
+    }
+    cout << defaultfloat << setprecision(6);
+}
+
+int main(int argc, char** argv) {
+    // --seeds <n> runs seeds 1..n; --budget <ms> (repeatable) replaces the deadline budgets;
+    // --gap <fraction> (repeatable) replaces the target gaps; --profiles <file> adds members;
+    // --synthetic <exercises>x<muscles> (repeatable) adds a synthetic workload, with
+    // --synthetic-profiles <n> extra members each; --out <prefix> names the CSV files
+    BenchmarkOptions options;
+    string prefix = "benchmark";
+    bool custom_budgets = false;
+    bool custom_gaps = false;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--seeds") == 0) {
+            options.seeds.clear();
+            for (int seed = 1; seed <= atoi(argv[i + 1]); ++seed) options.seeds.push_back(seed);
+        } else if (strcmp(argv[i], "--budget") == 0) {
+            if (!custom_budgets) options.budgets.clear();
+            custom_budgets = true;
+            options.budgets.push_back(atof(argv[i + 1]) / 1000.0);
+        } else if (strcmp(argv[i], "--gap") == 0) {
+            if (!custom_gaps) options.gaps.clear();
+            custom_gaps = true;
+            options.gaps.push_back(atof(argv[i + 1]));
+        } else if (strcmp(argv[i], "--synthetic") == 0) {
+            int exercise_count = 0;
+            int muscle_count = 0;
+            if (sscanf(argv[i + 1], "%dx%d", &exercise_count, &muscle_count) != 2 || exercise_count < 1 || muscle_count < 2) {
+                cerr << "Synthetic size must look like 1000x100" << endl;
+                return 1;
+            }
+            options.synthetic_sizes.push_back({exercise_count, muscle_count});
+        } else if (strcmp(argv[i], "--synthetic-profiles") == 0) {
+            options.synthetic_profiles = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--profiles") == 0) {
+            options.profiles_file = argv[i + 1];
+        } else if (strcmp(argv[i], "--out") == 0) {
+            prefix = argv[i + 1];
+        } else {
+            continue;
+        }
+        ++i;
+    }
+
+    vector<BenchmarkRun> runs = run_optimizer_benchmarks(options);
+    vector<BenchmarkRun> generator_runs = run_generator_benchmarks(options);
+    runs.insert(runs.end(), generator_runs.begin(), generator_runs.end());
+
+    print_summary(runs);
+    for (const auto& [exercise_count, muscle_count] : options.synthetic_sizes) {
+        cout << "greedy not run on " << synthetic_profile_name(exercise_count, muscle_count)
+             << ": the generator only knows its built-in catalog\n";
+    }
+    if (!write_runs_csv(runs, prefix + "_runs.csv") || !write_curves_csv(runs, options.gaps, prefix + "_curves.csv")) return 1;
+    cout << "Runs saved to " << prefix << "_runs.csv, time-to-target curves to " << prefix << "_curves.csv\n";
+    return 0;
+}
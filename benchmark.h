@@ -0,0 +1,44 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include <utility>
+
+// Struct to hold the benchmark settings: every engine runs once per seed and profile, and the
+// deadline annealer once more per budget
+struct BenchmarkOptions {
+    std::vector<unsigned int> seeds = {1, 2, 3};
+    std::vector<double> budgets = {0.05, 0.2, 1.0};  // seconds
+    std::string profiles_file;                        // extra members besides the default one
+    std::vector<double> gaps = {0.0, 0.05, 0.25};     // targets as a fraction above the best known cost
+    std::vector<std::pair<int, int>> synthetic_sizes; // (exercises, muscles) of synthetic workloads to add
+    int synthetic_profiles = 0;                       // members per synthetic workload besides its base one
+};
+
+// Struct to hold one point of a run's best-so-far curve
+struct BenchmarkPoint {
+    double seconds;
+    double best_cost;
+};
+
+// Struct to hold the outcome of one engine run. Costs are only comparable within a metric: the
+// greedy generator has its own catalog and is scored by volume_deficit_cost, the optimizers by
+// compute_cost.
+struct BenchmarkRun {
+    std::string engine;
+    std::string profile;
+    std::string metric;
+    unsigned int seed;
+    double budget;                       // seconds; 0 when the engine stops on its own
+    double cost;
+    int violations;
+    double seconds;
+    std::vector<BenchmarkPoint> curve;   // best cost so far, on each improvement and at the end
+};
+
+std::string synthetic_profile_name(int exercises, int muscles);
+std::vector<BenchmarkRun> run_optimizer_benchmarks(const BenchmarkOptions& options);
+std::vector<BenchmarkRun> run_generator_benchmarks(const BenchmarkOptions& options);
+
+#endif // BENCHMARK_H
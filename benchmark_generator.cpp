@@ -0,0 +1,34 @@
+#include "benchmark.h"
+#include "generator.h"
+#include <iostream>
+#include <sstream>
+#include <chrono>
+
+using namespace std;
+
+// Function to run the greedy generator on its default catalog for every seed. It has no time
+// budget or intermediate bests, so each run is a single point. Its catalog is compiled in, so it
+// cannot run on synthetic workloads; main reports those as skipped.
+vector<BenchmarkRun> run_generator_benchmarks(const BenchmarkOptions& options) {
+    unordered_map<string, Exercise> exercises_map;
+    for (const auto& ex : exercises) {
+        exercises_map[ex.name] = ex;
+    }
+    vector<BenchmarkRun> runs;
+    for (unsigned int seed : options.seeds) {
+        unordered_map<int, vector<Structure>> routine;
+        unordered_map<int, double> day_times;
+        mt19937 g(seed);
+        ostringstream discard;
+        streambuf* saved = cout.rdbuf(discard.rdbuf());
+        auto start = chrono::steady_clock::now();
+        generate_routine(g, routine, day_times);
+        auto end = chrono::steady_clock::now();
+        cout.rdbuf(saved);
+        double seconds = chrono::duration<double>(end - start).count();
+        double cost = volume_deficit_cost(routine, exercises_map);
+        int violations = check_generated_routine(routine, exercises_map).size();
+        runs.push_back({"greedy", "greedy_catalog", "volume_deficit", seed, 0.0, cost, violations, seconds, {{seconds, cost}}});
+    }
+    return runs;
+}
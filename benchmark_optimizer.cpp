@@ -0,0 +1,113 @@
+#include "benchmark.h"
+#include "optimizer.h"
+#include "day_templates.h"
+#include "profile.h"
+#include "neighbor_batch.h"
+#include "genetic.h"
+#include "synthetic.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+
+using namespace std;
+
+// Function to run one engine with its output silenced, timing it and recording every new best
+// through the progress observer; engines without one contribute only their final point
+static BenchmarkRun run_engine(const string& engine, const vector<Exercise>& catalog, const UserProfile& profile, unsigned int seed, double budget,
+                               const function<vector<vector<RoutineEntry>>(ProgressObserver*)>& engine_run) {
+    BenchmarkRun run{engine, profile.user_id, "compute_cost", seed, budget, 0.0, 0, 0.0, {}};
+    auto start = chrono::steady_clock::now();
+    ProgressObserver progress;
+    progress.interval = 0;
+    progress.min_seconds = 0.0;
+    progress.callback = [&](const ProgressView& view) {
+        if (view.improved || view.final) {
+            run.curve.push_back({chrono::duration<double>(chrono::steady_clock::now() - start).count(), view.best_cost});
+        }
+    };
+    ostringstream discard;
+    streambuf* saved = cout.rdbuf(discard.rdbuf());
+    vector<vector<RoutineEntry>> routine = engine_run(&progress);
+    auto end = chrono::steady_clock::now();
+    cout.rdbuf(saved);
+    run.seconds = chrono::duration<double>(end - start).count();
+    run.cost = compute_cost(routine, profile.mav_targets, catalog, &profile.overrides);
+    run.violations = check_routine(routine, catalog, &profile.overrides).size();
+    run.curve.push_back({run.seconds, run.cost});
+    return run;
+}
+
+// Function to run every optimizer engine over one profile and seed
+static void run_profile(const vector<Exercise>& base_catalog, const UserProfile& profile, unsigned int seed, const BenchmarkOptions& options, vector<BenchmarkRun>& runs) {
+    vector<Exercise> catalog = profile_exercises(profile, base_catalog);
+    const OptimizerProfile* overrides = &profile.overrides;
+    runs.push_back(run_engine("anneal", catalog, profile, seed, 0.0, [&](ProgressObserver* progress) {
+        OptimizerTelemetry telemetry;
+        return optimize_routine(catalog, profile.mav_targets, telemetry, seed, overrides, nullptr, progress);
+    }));
+    runs.push_back(run_engine("anneal_batched8", catalog, profile, seed, 0.0, [&](ProgressObserver* progress) {
+        OptimizerTelemetry telemetry;
+        return optimize_routine_batched(catalog, profile.mav_targets, telemetry, seed, {8, BatchSelection::Metropolis}, overrides, progress);
+    }));
+    runs.push_back(run_engine("genetic", catalog, profile, seed, 0.0, [&](ProgressObserver* progress) {
+        GeneticOptions genetic;
+        genetic.seed = seed;
+        return optimize_routine_genetic(catalog, profile.mav_targets, genetic, overrides, progress);
+    }));
+    runs.push_back(run_engine("templates", catalog, profile, seed, 0.0, [&](ProgressObserver*) {
+        DayTemplateLibrary library = build_day_templates(catalog, profile.mav_targets, overrides);
+        return optimize_day_templates(library, seed);
+    }));
+    for (double budget : options.budgets) {
+        runs.push_back(run_engine("anneal_deadline", catalog, profile, seed, budget, [&](ProgressObserver* progress) {
+            OptimizerTelemetry telemetry;
+            return optimize_routine_within(catalog, profile.mav_targets, telemetry, seed, budget, overrides, progress).routine;
+        }));
+    }
+}
+
+// Function to run every engine over each member of a catalog, for every seed
+static void run_catalog(const vector<Exercise>& catalog, const vector<UserProfile>& profiles, const BenchmarkOptions& options, vector<BenchmarkRun>& runs) {
+    for (const auto& profile : profiles) {
+        for (unsigned int seed : options.seeds) {
+            cerr << "Benchmarking optimizers: profile " << profile.user_id << ", seed " << seed << endl;
+            run_profile(catalog, profile, seed, options, runs);
+        }
+    }
+}
+
+// Function to name a synthetic workload's base member after its size
+string synthetic_profile_name(int exercises, int muscles) {
+    return "synthetic_" + to_string(exercises) + "x" + to_string(muscles);
+}
+
+// Function to run the optimizer engines over the default member and any members in the
+// profiles file, then over each synthetic workload. Synthetic members are named after their
+// workload's size (e.g. synthetic_1000x100, synthetic_1000x100_m1) so the summary reads as a
+// scaling table.
+vector<BenchmarkRun> run_optimizer_benchmarks(const BenchmarkOptions& options) {
+    vector<UserProfile> profiles = {default_profile("default")};
+    if (!options.profiles_file.empty()) {
+        ifstream in(options.profiles_file);
+        if (!in) {
+            cerr << "Error opening file " << options.profiles_file << endl;
+        } else {
+            ProfileStream stream = open_profile_stream(in, profile_format_for(options.profiles_file));
+            UserProfile profile;
+            while (next_profile(stream, profile)) profiles.push_back(profile);
+        }
+    }
+    vector<BenchmarkRun> runs;
+    run_catalog(exercises, profiles, options, runs);
+    for (const auto& [exercise_count, muscle_count] : options.synthetic_sizes) {
+        SyntheticOptions synthetic;
+        synthetic.exercises = exercise_count;
+        synthetic.muscles = muscle_count;
+        synthetic.profiles = options.synthetic_profiles;
+        synthetic.name = synthetic_profile_name(exercise_count, muscle_count);
+        SyntheticWorkload workload = make_synthetic_workload(synthetic);
+        run_catalog(workload.exercises, workload.profiles, options, runs);
+    }
+    return runs;
+}
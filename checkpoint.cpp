@@ -0,0 +1,267 @@
+#include "checkpoint.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_set>
+
+using namespace std;
+
+// File signature and layout version
+const char CHECKPOINT_MAGIC[4] = {'R', 'O', 'C', 'K'};
+const uint32_t CHECKPOINT_VERSION = 2;
+
+// Bounds on the size fields a checkpoint may declare, checked before anything is allocated
+const uint32_t MAX_CHECKPOINT_STRING = 256;
+const uint32_t MAX_CHECKPOINT_VOLUMES = 1024;
+
+// Function to write a trivially copyable value
+template <typename T>
+static void write_value(ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Function to read a trivially copyable value
+template <typename T>
+static bool read_value(istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+static void write_string(ostream& out, const string& value) {
+    write_value(out, static_cast<uint32_t>(value.size()));
+    out.write(value.data(), value.size());
+}
+
+static bool read_string(istream& in, string& value) {
+    uint32_t size;
+    if (!read_value(in, size) || size > MAX_CHECKPOINT_STRING) return false;
+    value.resize(size);
+    return static_cast<bool>(in.read(&value[0], size));
+}
+
+static void write_routine(ostream& out, const vector<vector<RoutineEntry>>& routine) {
+    write_value(out, static_cast<uint32_t>(routine.size()));
+    for (const auto& day : routine) {
+        write_value(out, static_cast<uint32_t>(day.size()));
+        for (const auto& entry : day) {
+            write_string(out, entry.exercise);
+            write_value(out, static_cast<int32_t>(entry.sets));
+        }
+    }
+}
+
+// Function to read a routine, rejecting anything run_annealing could not have written: a day
+// count other than TOTAL_DAYS, more than MAX_EXERCISES_PER_DAY entries, set counts outside
+// [MIN_SETS, MAX_SETS] or exercises missing from the catalog
+static bool read_routine(istream& in, const unordered_set<string>& names, vector<vector<RoutineEntry>>& routine) {
+    uint32_t days;
+    if (!read_value(in, days) || days != TOTAL_DAYS) return false;
+    routine.assign(days, {});
+    for (auto& day : routine) {
+        uint32_t entries;
+        if (!read_value(in, entries) || entries > MAX_EXERCISES_PER_DAY) return false;
+        day.resize(entries);
+        for (auto& entry : day) {
+            int32_t sets;
+            if (!read_string(in, entry.exercise) || !read_value(in, sets)) return false;
+            if (!names.count(entry.exercise) || sets < MIN_SETS || sets > MAX_SETS) return false;
+            entry.sets = sets;
+        }
+    }
+    return true;
+}
+
+static void write_doubles(ostream& out, const vector<double>& values) {
+    write_value(out, static_cast<uint32_t>(values.size()));
+    for (double value : values) write_value(out, value);
+}
+
+// Function to read a vector that must hold exactly expected values
+static bool read_doubles(istream& in, vector<double>& values, uint32_t expected) {
+    uint32_t size;
+    if (!read_value(in, size) || size != expected) return false;
+    values.resize(size);
+    for (double& value : values) {
+        if (!read_value(in, value)) return false;
+    }
+    return true;
+}
+
+// Function to fingerprint a catalog by its exercise names (FNV-1a), so a checkpoint is not
+// resumed against a different catalog
+static uint64_t catalog_fingerprint(const vector<Exercise>& exercises) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const auto& ex : exercises) {
+        for (char c : ex.name + '\n') {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+// Function to write the RNG as the 32-bit words of its textual state
+static void write_generator(ostream& out, const mt19937& gen) {
+    stringstream text;
+    text << gen;
+    vector<uint32_t> words;
+    unsigned long word;
+    while (text >> word) words.push_back(static_cast<uint32_t>(word));
+    write_value(out, static_cast<uint32_t>(words.size()));
+    for (uint32_t w : words) write_value(out, w);
+}
+
+static bool read_generator(istream& in, mt19937& gen) {
+    uint32_t size;
+    if (!read_value(in, size) || size != mt19937::state_size + 1) return false;
+    stringstream text;
+    for (uint32_t i = 0; i < size; ++i) {
+        uint32_t word;
+        if (!read_value(in, word)) return false;
+        text << word << ' ';
+    }
+    return static_cast<bool>(text >> gen);
+}
+
+// Function to write a checkpoint; the file is written beside the target and renamed over it,
+// so a run killed mid-write leaves the previous checkpoint intact
+bool save_checkpoint(const AnnealingState& state, const OptimizerTelemetry& telemetry, const vector<Exercise>& exercises, const string& filename) {
+    string partial = filename + ".tmp";
+    {
+        ofstream out(partial, ios::binary);
+        if (!out) {
+            cerr << "Error opening file " << partial << endl;
+            return false;
+        }
+        out.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+        write_value(out, CHECKPOINT_VERSION);
+        write_value(out, catalog_fingerprint(exercises));
+
+        write_value(out, static_cast<int32_t>(state.iteration));
+        write_value(out, state.temperature);
+        write_value(out, state.current_cost);
+        write_value(out, state.best_cost);
+        write_routine(out, state.routine);
+        write_routine(out, state.best_routine);
+        write_value(out, static_cast<uint32_t>(state.volumes.size()));
+        for (const auto& [muscle, volume] : state.volumes) {
+            write_string(out, muscle);
+            write_value(out, volume);
+        }
+        write_value(out, state.selector.alpha);
+        write_value(out, state.selector.beta);
+        write_value(out, state.selector.p_min);
+        write_doubles(out, state.selector.quality);
+        write_doubles(out, state.selector.probability);
+        write_generator(out, state.gen);
+
+        write_value(out, static_cast<int64_t>(telemetry.iterations));
+        write_value(out, static_cast<int64_t>(telemetry.infeasible));
+        write_value(out, static_cast<int64_t>(telemetry.cost_table_hits));
+        write_value(out, telemetry.perturb_seconds);
+        write_value(out, telemetry.cost_seconds);
+        write_value(out, telemetry.accept_seconds);
+        for (const auto& stats : telemetry.moves) {
+            for (long counter : {stats.attempts, stats.acceptances, stats.improvements, stats.infeasible, stats.no_ops, stats.screened}) {
+                write_value(out, static_cast<int64_t>(counter));
+            }
+        }
+        write_value(out, static_cast<int32_t>(telemetry.sample_interval));
+        write_value(out, static_cast<uint32_t>(telemetry.trajectory.size()));
+        for (const auto& sample : telemetry.trajectory) {
+            write_value(out, static_cast<int32_t>(sample.iteration));
+            write_value(out, sample.temperature);
+            write_value(out, sample.current_cost);
+            write_value(out, sample.best_cost);
+        }
+        if (!out.flush()) {
+            cerr << "Error writing checkpoint " << partial << endl;
+            return false;
+        }
+    }
+    if (rename(partial.c_str(), filename.c_str()) != 0) {
+        cerr << "Error replacing checkpoint " << filename << endl;
+        return false;
+    }
+    return true;
+}
+
+// Function to read a checkpoint written by save_checkpoint for the same catalog. Every size field
+// is bounded and every routine checked against the catalog; state and telemetry are only changed
+// when the whole file reads cleanly.
+bool load_checkpoint(AnnealingState& state, OptimizerTelemetry& telemetry, const vector<Exercise>& exercises, const string& filename) {
+    ifstream in(filename, ios::binary);
+    if (!in) {
+        cerr << "Error opening file " << filename << endl;
+        return false;
+    }
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    uint32_t version;
+    uint64_t fingerprint;
+    if (!in.read(magic, sizeof(magic)) || !equal(magic, magic + sizeof(magic), CHECKPOINT_MAGIC) ||
+        !read_value(in, version) || version != CHECKPOINT_VERSION) {
+        cerr << filename << " is not a version " << CHECKPOINT_VERSION << " checkpoint" << endl;
+        return false;
+    }
+    if (!read_value(in, fingerprint) || fingerprint != catalog_fingerprint(exercises)) {
+        cerr << filename << " was written for a different exercise catalog" << endl;
+        return false;
+    }
+    unordered_set<string> names;
+    for (const auto& ex : exercises) names.insert(ex.name);
+
+    AnnealingState loaded;
+    OptimizerTelemetry counters;
+    int32_t iteration = 0;
+    uint32_t volumes = 0;
+    bool ok = read_value(in, iteration) && iteration >= 0 && read_value(in, loaded.temperature) &&
+              read_value(in, loaded.current_cost) && read_value(in, loaded.best_cost) &&
+              read_routine(in, names, loaded.routine) && read_routine(in, names, loaded.best_routine) &&
+              read_value(in, volumes) && volumes <= MAX_CHECKPOINT_VOLUMES;
+    loaded.iteration = iteration;
+    for (uint32_t i = 0; ok && i < volumes; ++i) {
+        string muscle;
+        double volume = 0.0;
+        ok = read_string(in, muscle) && read_value(in, volume);
+        loaded.volumes[muscle] = volume;
+    }
+    ok = ok && read_value(in, loaded.selector.alpha) && read_value(in, loaded.selector.beta) &&
+         read_value(in, loaded.selector.p_min) && read_doubles(in, loaded.selector.quality, NUM_MOVE_TYPES) &&
+         read_doubles(in, loaded.selector.probability, NUM_MOVE_TYPES) && read_generator(in, loaded.gen);
+
+    int64_t iterations = 0, infeasible = 0, cost_table_hits = 0;
+    ok = ok && read_value(in, iterations) && read_value(in, infeasible) && read_value(in, cost_table_hits) &&
+         read_value(in, counters.perturb_seconds) && read_value(in, counters.cost_seconds) &&
+         read_value(in, counters.accept_seconds);
+    counters.iterations = iterations;
+    counters.infeasible = infeasible;
+    counters.cost_table_hits = cost_table_hits;
+    for (auto& stats : counters.moves) {
+        for (long* counter : {&stats.attempts, &stats.acceptances, &stats.improvements, &stats.infeasible, &stats.no_ops, &stats.screened}) {
+            int64_t value = 0;
+            ok = ok && read_value(in, value);
+            *counter = value;
+        }
+    }
+    int32_t sample_interval = 0;
+    uint32_t samples = 0;
+    ok = ok && read_value(in, sample_interval) && sample_interval > 0 && read_value(in, samples);
+    counters.sample_interval = sample_interval;
+    for (uint32_t i = 0; ok && i < samples; ++i) {
+        int32_t sample_iteration = 0;
+        TrajectorySample sample;
+        ok = read_value(in, sample_iteration) && read_value(in, sample.temperature) &&
+             read_value(in, sample.current_cost) && read_value(in, sample.best_cost);
+        sample.iteration = sample_iteration;
+        counters.trajectory.push_back(sample);
+    }
+    if (!ok) {
+        cerr << filename << " is truncated or corrupt" << endl;
+        return false;
+    }
+    state = move(loaded);
+    telemetry = move(counters);
+    return true;
+}
@@ -0,0 +1,15 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <string>
+#include <vector>
+#include "optimizer.h"
+#include "telemetry.h"
+
+// Compact binary checkpoints of a simulated annealing run: iteration, temperature, costs, current
+// and best routines, volumes, operator selector, mt19937 state and telemetry. Files are native
+// byte order and meant to be resumed on the same kind of machine and standard library.
+bool save_checkpoint(const AnnealingState& state, const OptimizerTelemetry& telemetry, const std::vector<Exercise>& exercises, const std::string& filename);
+bool load_checkpoint(AnnealingState& state, OptimizerTelemetry& telemetry, const std::vector<Exercise>& exercises, const std::string& filename);
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,72 @@
+#include "cost_weights.h"
+#include <fstream>
+#include <iostream>
+#include <cstdlib>
+
+using namespace std;
+
+CostWeights cost_weights;
+
+// Names of the scalar weights in weights files and profiles
+static const struct {
+    const char* key;
+    double CostWeights::*field;
+} WEIGHT_KEYS[] = {
+    {"excess_volume", &CostWeights::excess_volume},
+    {"frequency", &CostWeights::frequency},
+    {"overtime", &CostWeights::overtime},
+    {"time_variance_over", &CostWeights::time_variance_over},
+    {"time_variance_under", &CostWeights::time_variance_under},
+    {"compound_first", &CostWeights::compound_first},
+    {"inclusion", &CostWeights::inclusion},
+    {"structure", &CostWeights::structure},
+    {"default_deficit", &CostWeights::default_deficit}
+};
+
+// Function to set one scalar weight by name; false for unknown names and negative weights
+bool set_cost_weight(CostWeights& weights, const string& key, double value) {
+    if (value < 0.0) return false;
+    for (const auto& entry : WEIGHT_KEYS) {
+        if (key == entry.key) {
+            weights.*entry.field = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function to load weights from a file of "key value" lines, with "deficit <muscle> <value>" for
+// per-muscle deficit weights and # comments. Keys not in the file keep their current values.
+bool load_cost_weights(const string& filename, CostWeights& weights) {
+    ifstream in(filename);
+    if (!in) {
+        cerr << "Error opening file " << filename << endl;
+        return false;
+    }
+    string line;
+    int line_number = 0;
+    bool ok = true;
+    while (getline(in, line)) {
+        ++line_number;
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty() || line[0] == '#') continue;
+        size_t key_end = line.find_first_of(" \t");
+        size_t value_start = line.find_last_of(" \t");
+        string key = line.substr(0, key_end);
+        string value_text = value_start == string::npos ? "" : line.substr(value_start + 1);
+        char* end = nullptr;
+        double value = strtod(value_text.c_str(), &end);
+        bool valid = !value_text.empty() && end && *end == '\0' && value >= 0.0;
+        if (valid && key == "deficit" && value_start > key_end) {
+            string muscle = line.substr(key_end, value_start - key_end);
+            muscle.erase(0, muscle.find_first_not_of(" \t"));
+            muscle.erase(muscle.find_last_not_of(" \t") + 1);
+            weights.deficit_weights[muscle] = value;
+        } else if (!valid || key_end != value_start || !set_cost_weight(weights, key, value)) {
+            cerr << filename << " line " << line_number << ": invalid weight \"" << line << "\"" << endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
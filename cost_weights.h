@@ -0,0 +1,32 @@
+#ifndef COST_WEIGHTS_H
+#define COST_WEIGHTS_H
+
+#include <string>
+#include <unordered_map>
+
+// Penalty weights of compute_cost. The defaults are the built-in tuning; a weights file loaded at
+// startup replaces the active set, and a member profile may carry its own copy.
+struct CostWeights {
+    double excess_volume = 200.0;         // per squared set above a muscle's upper bound
+    double frequency = 10000.0;           // per weekly use of an exercise beyond two
+    double overtime = 4000.0;             // per minute above MAX_TIME_PER_DAY
+    double time_variance_over = 1500.0;   // per squared minute a day runs above the average
+    double time_variance_under = 1000.0;  // per squared minute a day runs below the average
+    double compound_first = 50000.0;      // per day not led by a compound
+    double inclusion = 80000.0;           // when Leg Curl (Short Head coverage) is missing
+    double structure = 1000000.0;         // per repeat, missing or extra exercise, or extra leg exercise
+    double default_deficit = 8000.0;      // per squared set below target, for muscles not listed below
+    // Deficit weight per muscle; 0 leaves the muscle out of volume optimization entirely
+    std::unordered_map<std::string, double> deficit_weights = {
+        {"Short Head", 15000.0}, {"Lower Traps", 15000.0}, {"Lateral Delts", 15000.0}, {"Quads", 15000.0},
+        {"Glutes", 0.0}, {"Lower Back", 0.0}
+    };
+};
+
+// Weights used when a profile carries none (defined in cost_weights.cpp)
+extern CostWeights cost_weights;
+
+bool set_cost_weight(CostWeights& weights, const std::string& key, double value);
+bool load_cost_weights(const std::string& filename, CostWeights& weights);
+
+#endif // COST_WEIGHTS_H
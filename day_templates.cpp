@@ -0,0 +1,254 @@
+#include "day_templates.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+// Function to enumerate every day that satisfies the per-day rules (3-6 distinct exercises,
+// at most 2 leg exercises, led by a compound) together with every sets allocation that fits
+// in MAX_TIME_PER_DAY. Each exercise subset appears once, led by its first compound.
+DayTemplateLibrary build_day_templates(const vector<Exercise>& exercises,
+                                       const unordered_map<string, MuscleGroup>& mav_targets,
+                                       const OptimizerProfile* profile,
+                                       size_t max_templates) {
+    DayTemplateLibrary library;
+    library.penalties = weights_for(profile);
+    for (const auto& [muscle, target] : mav_targets) library.muscles.push_back(muscle);
+    sort(library.muscles.begin(), library.muscles.end());
+    for (const auto& muscle : library.muscles) {
+        library.targets.push_back(mav_targets.at(muscle));
+        library.weights.push_back(volume_deficit_weight(muscle, profile));
+    }
+    size_t num_muscles = library.muscles.size();
+
+    // Per-set volume of each exercise over the library's muscle order
+    vector<vector<float>> per_set(exercises.size(), vector<float>(num_muscles, 0.0f));
+    for (size_t e = 0; e < exercises.size(); ++e) {
+        const Exercise& ex = exercises[e];
+        library.exercise_names.push_back(ex.name);
+        library.is_leg.push_back(ex.is_leg);
+        if (ex.name == "Leg Curl") library.leg_curl = e;
+        auto add = [&](const vector<string>& muscles, float weight) {
+            for (const auto& muscle : muscles) {
+                auto it = lower_bound(library.muscles.begin(), library.muscles.end(), muscle);
+                if (it != library.muscles.end() && *it == muscle) per_set[e][it - library.muscles.begin()] += weight;
+            }
+        };
+        add(ex.primary, 1.0f);
+        add(ex.secondary, 0.5f);
+        add(ex.isometric, 0.25f);
+        library.exercise_volumes.insert(library.exercise_volumes.end(), per_set[e].begin(), per_set[e].end());
+    }
+
+    int max_total_sets = static_cast<int>(MAX_TIME_PER_DAY / TIME_PER_SET);
+    library.offset.push_back(0);
+    vector<int> subset;
+    vector<int> sets;
+
+    // Emit every sets allocation of the current (ordered) subset within the time limit
+    auto emit_allocations = [&](auto& self, size_t i, int total_sets) -> void {
+        if (!library.complete) return;
+        if (i == subset.size()) {
+            if (library.size() >= max_templates) {
+                library.complete = false;
+                return;
+            }
+            vector<float> volume(num_muscles, 0.0f);
+            for (size_t k = 0; k < subset.size(); ++k) {
+                library.entry_exercise.push_back(subset[k]);
+                library.entry_sets.push_back(sets[k]);
+                for (size_t m = 0; m < num_muscles; ++m) volume[m] += sets[k] * per_set[subset[k]][m];
+            }
+            library.volumes.insert(library.volumes.end(), volume.begin(), volume.end());
+            library.times.push_back(total_sets * TIME_PER_SET);
+            library.offset.push_back(library.entry_exercise.size());
+            return;
+        }
+        int remaining = subset.size() - i - 1;
+        for (int s = MIN_SETS; s <= MAX_SETS && total_sets + s + remaining * MIN_SETS <= max_total_sets; ++s) {
+            sets[i] = s;
+            self(self, i + 1, total_sets + s);
+        }
+    };
+
+    // Grow index-ordered subsets; a subset is emitted with its first compound moved to the front
+    auto grow = [&](auto& self, size_t next, int legs, int first_compound) -> void {
+        if (!library.complete) return;
+        int size = subset.size();
+        if (size >= MIN_EXERCISES_PER_DAY && first_compound >= 0) {
+            vector<int> ordered = subset;
+            rotate(ordered.begin(), ordered.begin() + first_compound, ordered.begin() + first_compound + 1);
+            swap(subset, ordered);
+            sets.assign(subset.size(), MIN_SETS);
+            emit_allocations(emit_allocations, 0, 0);
+            swap(subset, ordered);
+        }
+        if (size == MAX_EXERCISES_PER_DAY || (size + 1) * MIN_SETS > max_total_sets) return;
+        for (size_t e = next; e < exercises.size(); ++e) {
+            int new_legs = legs + (exercises[e].is_leg ? 1 : 0);
+            if (new_legs > 2) continue;
+            subset.push_back(e);
+            self(self, e + 1, new_legs, first_compound < 0 && exercises[e].is_compound ? size : first_compound);
+            subset.pop_back();
+        }
+    };
+    grow(grow, 0, 0, -1);
+
+    if (!library.complete) {
+        cerr << "Day template library truncated at " << max_templates << " templates" << endl;
+    }
+    return library;
+}
+
+// Function to expand a template into routine entries
+vector<RoutineEntry> template_day(const DayTemplateLibrary& library, size_t t) {
+    vector<RoutineEntry> day;
+    for (uint32_t i = library.offset[t]; i < library.offset[t + 1]; ++i) {
+        day.push_back({library.exercise_names[library.entry_exercise[i]], library.entry_sets[i]});
+    }
+    return day;
+}
+
+// Function to look up an exercise in the library; -1 when the catalog does not have it
+int exercise_index(const DayTemplateLibrary& library, const string& name) {
+    auto it = find(library.exercise_names.begin(), library.exercise_names.end(), name);
+    return it == library.exercise_names.end() ? -1 : it - library.exercise_names.begin();
+}
+
+// Function to create an empty week sized for the library
+TemplateWeek make_template_week(const DayTemplateLibrary& library) {
+    TemplateWeek week;
+    week.days.assign(TOTAL_DAYS, 0);
+    week.volume.assign(library.muscles.size(), 0.0);
+    week.frequency.assign(library.exercise_names.size(), 0);
+    week.day_times.assign(TOTAL_DAYS, 0.0);
+    week.skipped.assign(TOTAL_DAYS, false);
+    return week;
+}
+
+// Function to add (sign 1) or remove (sign -1) a template's contribution on a day
+void apply_template(const DayTemplateLibrary& library, TemplateWeek& week, int day, size_t t, int sign) {
+    size_t num_muscles = library.muscles.size();
+    const float* volume = &library.volumes[t * num_muscles];
+    for (size_t m = 0; m < num_muscles; ++m) week.volume[m] += sign * volume[m];
+    for (uint32_t i = library.offset[t]; i < library.offset[t + 1]; ++i) {
+        week.frequency[library.entry_exercise[i]] += sign;
+    }
+    week.day_times[day] = sign > 0 ? library.times[t] : 0.0;
+}
+
+// Function to add or remove arbitrary entries on a day (days that are not templates)
+void apply_entries(const DayTemplateLibrary& library, TemplateWeek& week, int day, const vector<RoutineEntry>& entries, int sign) {
+    size_t num_muscles = library.muscles.size();
+    for (const auto& entry : entries) {
+        int e = exercise_index(library, entry.exercise);
+        if (e < 0) continue;
+        const float* volume = &library.exercise_volumes[e * num_muscles];
+        for (size_t m = 0; m < num_muscles; ++m) week.volume[m] += sign * entry.sets * volume[m];
+        week.frequency[e] += sign;
+        week.day_times[day] += sign * entry.sets * TIME_PER_SET;
+    }
+}
+
+// Function to replace a day's template
+void set_day(const DayTemplateLibrary& library, TemplateWeek& week, int day, size_t t) {
+    apply_template(library, week, day, week.days[day], -1);
+    week.days[day] = t;
+    apply_template(library, week, day, t, 1);
+}
+
+// Function to evaluate compute_cost over the dense weekly totals, leaving out the per-day
+// structure and compound-first terms (zero for templates, constant for fixed days). The time
+// balance averages over the days not marked skipped.
+double week_cost(const DayTemplateLibrary& library, const TemplateWeek& week) {
+    const CostWeights& penalties = library.penalties;
+    double cost = 0.0;
+    for (size_t m = 0; m < library.muscles.size(); ++m) {
+        if (library.weights[m] == 0.0) continue;
+        double vol = week.volume[m];
+        double deficit = library.targets[m].target - vol;
+        if (deficit > 0) {
+            cost += library.weights[m] * deficit * deficit;
+        } else if (vol > library.targets[m].upper_bound) {
+            cost += penalties.excess_volume * pow(vol - library.targets[m].upper_bound, 2);
+        }
+    }
+    for (int freq : week.frequency) {
+        if (freq > 2) cost += penalties.frequency * (freq - 2);
+    }
+    double avg_time = 0.0;
+    int trained_days = 0;
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        if (week.skipped[day]) continue;
+        avg_time += week.day_times[day];
+        ++trained_days;
+    }
+    avg_time /= max(1, trained_days);
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        if (week.skipped[day]) continue;
+        double diff = week.day_times[day] - avg_time;
+        cost += (diff > 0 ? penalties.time_variance_over : penalties.time_variance_under) * diff * diff;
+    }
+    if (library.leg_curl < 0 || week.frequency[library.leg_curl] == 0) cost += penalties.inclusion;
+    return cost;
+}
+
+// Function to choose one template per day by simulated annealing over the six template
+// indices, then polish each day with an exhaustive best-template pass until none improves
+vector<vector<RoutineEntry>> optimize_day_templates(const DayTemplateLibrary& library, unsigned int seed, int iterations) {
+    vector<vector<RoutineEntry>> routine(TOTAL_DAYS);
+    if (library.size() == 0) return routine;
+    mt19937 gen(seed);
+    uniform_int_distribution<size_t> template_dist(0, library.size() - 1);
+    uniform_int_distribution<> day_dist(0, TOTAL_DAYS - 1);
+
+    TemplateWeek week = make_template_week(library);
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        week.days[day] = template_dist(gen);
+        apply_template(library, week, day, week.days[day], 1);
+    }
+    double current_cost = week_cost(library, week);
+    vector<size_t> best_days = week.days;
+    double best_cost = current_cost;
+
+    double temp = 1500.0;
+    double cooling_rate = pow(0.01 / temp, 1.0 / max(1, iterations));
+    for (int iter = 0; iter < iterations; ++iter) {
+        int day = day_dist(gen);
+        size_t previous = week.days[day];
+        set_day(library, week, day, template_dist(gen));
+        double new_cost = week_cost(library, week);
+        if (new_cost < current_cost || uniform_real_distribution<>(0, 1)(gen) < exp((current_cost - new_cost) / temp)) {
+            current_cost = new_cost;
+            if (new_cost < best_cost) {
+                best_cost = new_cost;
+                best_days = week.days;
+            }
+        } else {
+            set_day(library, week, day, previous);
+        }
+        temp *= cooling_rate;
+    }
+
+    for (int day = 0; day < TOTAL_DAYS; ++day) set_day(library, week, day, best_days[day]);
+    current_cost = best_cost;
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        for (int day = 0; day < TOTAL_DAYS; ++day) {
+            size_t best = week.days[day];
+            for (size_t t = 0; t < library.size(); ++t) {
+                set_day(library, week, day, t);
+                double cost = week_cost(library, week);
+                if (cost < current_cost) {
+                    current_cost = cost;
+                    best = t;
+                    improved = true;
+                }
+            }
+            set_day(library, week, day, best);
+        }
+    }
+
+    for (int day = 0; day < TOTAL_DAYS; ++day) routine[day] = template_day(library, week.days[day]);
+    return routine;
+}
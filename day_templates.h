@@ -0,0 +1,50 @@
+#ifndef DAY_TEMPLATES_H
+#define DAY_TEMPLATES_H
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <random>
+#include "optimizer.h"
+
+// Every feasible day for a catalog, stored as flat indexed arrays. Template t lists
+// entry_exercise/entry_sets[offset[t], offset[t + 1]) with the leading compound first;
+// its weekly volume contribution is volumes[t * muscles.size(), ...] in the order of muscles.
+struct DayTemplateLibrary {
+    vector<string> exercise_names;
+    vector<bool> is_leg;
+    vector<string> muscles;            // mav_targets muscles, sorted
+    vector<MuscleGroup> targets;       // parallel to muscles
+    vector<double> weights;            // deficit weight per muscle (0 for muscles compute_cost skips)
+    CostWeights penalties;             // penalty weights resolved for the profile at build time
+    int leg_curl = -1;                 // exercise index of Leg Curl, -1 when absent
+    vector<float> exercise_volumes;    // per-set volume, [exercise * muscles.size() + muscle]
+    vector<uint32_t> offset;
+    vector<uint16_t> entry_exercise;
+    vector<uint8_t> entry_sets;
+    vector<float> volumes;
+    vector<float> times;
+    bool complete = true;              // false when enumeration stopped at max_templates
+    size_t size() const { return times.size(); }
+};
+
+// Weekly totals for one choice of days, updated incrementally as days change
+struct TemplateWeek {
+    vector<size_t> days;               // template per day (unused for fixed days)
+    vector<double> volume;
+    vector<int> frequency;
+    vector<double> day_times;
+    vector<bool> skipped;              // days left out of the time balance (skipped by a re-plan)
+};
+
+DayTemplateLibrary build_day_templates(const vector<Exercise>& exercises, const unordered_map<string, MuscleGroup>& mav_targets, const OptimizerProfile* profile = nullptr, size_t max_templates = 500000);
+vector<RoutineEntry> template_day(const DayTemplateLibrary& library, size_t t);
+int exercise_index(const DayTemplateLibrary& library, const string& name);
+TemplateWeek make_template_week(const DayTemplateLibrary& library);
+void apply_template(const DayTemplateLibrary& library, TemplateWeek& week, int day, size_t t, int sign);
+void apply_entries(const DayTemplateLibrary& library, TemplateWeek& week, int day, const vector<RoutineEntry>& entries, int sign);
+void set_day(const DayTemplateLibrary& library, TemplateWeek& week, int day, size_t t);
+double week_cost(const DayTemplateLibrary& library, const TemplateWeek& week);
+vector<vector<RoutineEntry>> optimize_day_templates(const DayTemplateLibrary& library, unsigned int seed, int iterations = 200000);
+
+#endif // DAY_TEMPLATES_H
@@ -0,0 +1,140 @@
+#include "equipment.h"
+#include "utils.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+// Minutes to re-pin a cable's height or swap its attachment
+const double CABLE_CHANGEOVER = 0.5;
+// Minutes to move the bench or pad on the center upright
+const double APPARATUS_CHANGEOVER = 1.5;
+// Minutes to walk to another station and load it
+const double STATION_CHANGEOVER = 1.0;
+// Days with more structures than this are ordered greedily instead of exactly
+const size_t MAX_EXACT_ORDERING = 6;
+
+// Function to look up the cable, apparatus and station an exercise uses
+Equipment exercise_equipment(const string& exercise) {
+    Equipment equipment{"None", "None", "None"};
+    if (exercise == "Cable Curl") equipment.cable = "Left Cable, Low Height";
+    else if (exercise == "Pulldown") equipment.cable = "Pulldown Cable";
+    else if (exercise == "Chest Fly") equipment.cable = "Both Cables, Medium Height";
+    else if (exercise.find("Cable") != string::npos) equipment.cable = "Left Cable, High Height";
+    if (exercise.find("Bench Press") != string::npos) equipment.apparatus = "Bench on Center Upright, Low";
+    else if (exercise == "Upper Back Rows") equipment.apparatus = "Bulldog Pad on Center Upright, High";
+    if (exercise.find("Bench Press") != string::npos) equipment.station = "Bench Press Station";
+    else if (exercise == "Squat") equipment.station = "Squat Rack";
+    else if (exercise == "Leg Extension") equipment.station = "Leg Extension Machine";
+    else if (exercise == "Leg Curl") equipment.station = "Leg Curl Machine";
+    return equipment;
+}
+
+// Function to calculate the minutes spent setting up "to" when "from" was the last setup used.
+// Each piece the next exercise needs costs its changeover unless it is already set that way.
+double changeover_time(const Equipment& from, const Equipment& to) {
+    double time = 0.0;
+    if (to.cable != "None" && to.cable != from.cable) time += CABLE_CHANGEOVER;
+    if (to.apparatus != "None" && to.apparatus != from.apparatus) time += APPARATUS_CHANGEOVER;
+    if (to.station != "None" && to.station != from.station) time += STATION_CHANGEOVER;
+    return time;
+}
+
+// Function to calculate the changeover between two consecutive structures: from the setup of the
+// last exercise of one to the first exercise of the next (changes inside a superset or tri-set
+// are part of its per-set time)
+double structure_changeover_time(const Structure& from, const Structure& to) {
+    if (from.exercises.empty() || to.exercises.empty()) return 0.0;
+    return changeover_time(exercise_equipment(from.exercises.back()), exercise_equipment(to.exercises.front()));
+}
+
+// Function to sum the changeovers of a day in its current order
+double day_changeover_time(const vector<Structure>& structures) {
+    double time = 0.0;
+    for (size_t i = 1; i < structures.size(); ++i) {
+        time += structure_changeover_time(structures[i - 1], structures[i]);
+    }
+    return time;
+}
+
+// Function to calculate the time of a day: its sets plus the changeovers between structures
+double day_time(const vector<Structure>& structures) {
+    double time = day_changeover_time(structures);
+    for (const auto& structure : structures) {
+        time += calculate_time(structure.exercises, structure.sets);
+    }
+    return time;
+}
+
+// Function to order a day's structures to minimize changeover time. The first structure (the
+// compound) stays first; the rest are an open-path TSP from it, solved exactly by bitmask DP
+// over subsets for up to MAX_EXACT_ORDERING structures and by nearest neighbour beyond that.
+// The current order is kept unless a strictly shorter one exists.
+void order_day_structures(vector<Structure>& structures) {
+    size_t n = structures.size();
+    if (n < 3) return;
+    vector<vector<double>> cost(n, vector<double>(n, 0.0));
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            if (i != j) cost[i][j] = structure_changeover_time(structures[i], structures[j]);
+        }
+    }
+
+    vector<size_t> order;
+    if (n <= MAX_EXACT_ORDERING) {
+        // best[mask][last]: cheapest path from structure 0 through the structures in mask
+        // (bit k is structure k + 1), ending at structure last + 1
+        size_t m = n - 1;
+        size_t full = (size_t(1) << m) - 1;
+        vector<vector<double>> best(full + 1, vector<double>(m, numeric_limits<double>::max()));
+        vector<vector<int>> previous(full + 1, vector<int>(m, -1));
+        for (size_t k = 0; k < m; ++k) best[size_t(1) << k][k] = cost[0][k + 1];
+        for (size_t mask = 1; mask <= full; ++mask) {
+            for (size_t last = 0; last < m; ++last) {
+                if (!(mask >> last & 1) || best[mask][last] == numeric_limits<double>::max()) continue;
+                for (size_t next = 0; next < m; ++next) {
+                    if (mask >> next & 1) continue;
+                    size_t grown = mask | (size_t(1) << next);
+                    double candidate = best[mask][last] + cost[last + 1][next + 1];
+                    if (candidate < best[grown][next]) {
+                        best[grown][next] = candidate;
+                        previous[grown][next] = static_cast<int>(last);
+                    }
+                }
+            }
+        }
+        size_t last = min_element(best[full].begin(), best[full].end()) - best[full].begin();
+        for (size_t mask = full; mask;) {
+            order.push_back(last + 1);
+            int prior = previous[mask][last];
+            mask &= ~(size_t(1) << last);
+            last = prior;
+        }
+        order.push_back(0);
+        reverse(order.begin(), order.end());
+    } else {
+        vector<bool> placed(n, false);
+        order.push_back(0);
+        placed[0] = true;
+        while (order.size() < n) {
+            size_t from = order.back();
+            size_t next = n;
+            for (size_t j = 1; j < n; ++j) {
+                if (!placed[j] && (next == n || cost[from][j] < cost[from][next])) next = j;
+            }
+            order.push_back(next);
+            placed[next] = true;
+        }
+    }
+
+    double current = 0.0;
+    double ordered = 0.0;
+    for (size_t i = 1; i < n; ++i) {
+        current += cost[i - 1][i];
+        ordered += cost[order[i - 1]][order[i]];
+    }
+    if (ordered >= current - 1e-9) return;
+    vector<Structure> reordered;
+    for (size_t i : order) reordered.push_back(structures[i]);
+    structures = reordered;
+}
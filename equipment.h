@@ -0,0 +1,22 @@
+#ifndef EQUIPMENT_H
+#define EQUIPMENT_H
+
+#include <string>
+#include <vector>
+#include "exercise_definitions.h"
+
+// Struct to hold the gym-floor setup an exercise needs ("None" where it needs nothing)
+struct Equipment {
+    std::string cable;
+    std::string apparatus;
+    std::string station;
+};
+
+Equipment exercise_equipment(const std::string& exercise);
+double changeover_time(const Equipment& from, const Equipment& to);
+double structure_changeover_time(const Structure& from, const Structure& to);
+double day_changeover_time(const std::vector<Structure>& structures);
+double day_time(const std::vector<Structure>& structures);
+void order_day_structures(std::vector<Structure>& structures);
+
+#endif // EQUIPMENT_H
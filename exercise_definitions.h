@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <utility>
 
 using namespace std;
 
@@ -17,7 +18,7 @@ struct Exercise {
     bool is_leg;
 };
 
-// Struct to represent a structure (straight set in this simplified version)
+// Struct to represent a structure (straight set, superset or tri-set)
 struct Structure {
     vector<string> exercises;
     int sets;
@@ -91,6 +92,87 @@ const vector<Exercise> exercises = {
     {"Lat Prayer", {"Lats", "Long Head"}, {}, {}, false, false}
 };
 
+// Exercise pairs that can share a superset or tri-set (compatible pairs from definitions.py)
+const vector<pair<string, string>> compatible_pairs = {
+    {"Incline Bench Press", "Leg Curl"},
+    {"Chest Fly", "Squat"},
+    {"Chest Fly", "Leg Curl"},
+    {"Chest Fly", "Upper Back Rows"},
+    {"Chest Fly", "Kelso Shrugs"},
+    {"Chest Fly", "Pulldown"},
+    {"Chest Fly", "Lat Prayer"},
+    {"Front Raise", "Lateral Raise"},
+    {"Front Raise", "Triceps Extension"},
+    {"Front Raise", "Squat"},
+    {"Front Raise", "Leg Curl"},
+    {"Front Raise", "Leg Extension"},
+    {"Front Raise", "Upper Back Rows"},
+    {"Front Raise", "Kelso Shrugs"},
+    {"Front Raise", "Rear Delts"},
+    {"Front Raise", "Cable Curl"},
+    {"Front Raise", "Pulldown"},
+    {"Front Raise", "Lat Prayer"},
+    {"Lateral Raise", "Triceps Extension"},
+    {"Lateral Raise", "Squat"},
+    {"Lateral Raise", "Leg Curl"},
+    {"Lateral Raise", "Leg Extension"},
+    {"Lateral Raise", "Upper Back Rows"},
+    {"Lateral Raise", "Kelso Shrugs"},
+    {"Lateral Raise", "Rear Delts"},
+    {"Lateral Raise", "Cable Curl"},
+    {"Lateral Raise", "Pulldown"},
+    {"Lateral Raise", "Lat Prayer"},
+    {"Triceps Extension", "Squat"},
+    {"Triceps Extension", "Leg Curl"},
+    {"Triceps Extension", "Leg Extension"},
+    {"Triceps Extension", "Upper Back Rows"},
+    {"Triceps Extension", "Kelso Shrugs"},
+    {"Triceps Extension", "Rear Delts"},
+    {"Triceps Extension", "Stiff-Legged Deadlift"},
+    {"Triceps Extension", "Pulldown"},
+    {"Triceps Extension", "Lat Prayer"},
+    {"Squat", "Leg Curl"},
+    {"Squat", "Leg Extension"},
+    {"Squat", "Shrugs"},
+    {"Squat", "Rear Delts"},
+    {"Squat", "Cable Curl"},
+    {"Squat", "Stiff-Legged Deadlift"},
+    {"Squat", "Lat Prayer"},
+    {"Leg Curl", "Shrugs"},
+    {"Leg Curl", "Upper Back Rows"},
+    {"Leg Curl", "Kelso Shrugs"},
+    {"Leg Curl", "Rear Delts"},
+    {"Leg Curl", "Cable Curl"},
+    {"Leg Curl", "Stiff-Legged Deadlift"},
+    {"Leg Curl", "Lat Prayer"},
+    {"Leg Extension", "Shrugs"},
+    {"Leg Extension", "Upper Back Rows"},
+    {"Leg Extension", "Rear Delts"},
+    {"Leg Extension", "Pulldown"},
+    {"Leg Extension", "Lat Prayer"},
+    {"Shrugs", "Upper Back Rows"},
+    {"Shrugs", "Kelso Shrugs"},
+    {"Shrugs", "Stiff-Legged Deadlift"},
+    {"Shrugs", "Pulldown"},
+    {"Shrugs", "Lat Prayer"},
+    {"Upper Back Rows", "Kelso Shrugs"},
+    {"Upper Back Rows", "Rear Delts"},
+    {"Upper Back Rows", "Cable Curl"},
+    {"Upper Back Rows", "Stiff-Legged Deadlift"},
+    {"Upper Back Rows", "Lat Prayer"},
+    {"Kelso Shrugs", "Rear Delts"},
+    {"Kelso Shrugs", "Pulldown"},
+    {"Kelso Shrugs", "Lat Prayer"},
+    {"Rear Delts", "Stiff-Legged Deadlift"},
+    {"Rear Delts", "Pulldown"},
+    {"Rear Delts", "Lat Prayer"},
+    {"Cable Curl", "Pulldown"},
+    {"Cable Curl", "Lat Prayer"},
+    {"Stiff-Legged Deadlift", "Pulldown"},
+    {"Stiff-Legged Deadlift", "Lat Prayer"},
+    {"Pulldown", "Lat Prayer"}
+};
+
 // Constants required by routine_optimizer.cpp
 const int TOTAL_DAYS = 6;
 const int MIN_EXERCISES_PER_DAY = 3;
@@ -0,0 +1,297 @@
+#include "floor_schedule.h"
+#include "equipment.h"
+#include "utils.h"
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <limits>
+#include <cmath>
+
+using namespace std;
+
+// Struct to hold an athlete's day with its durations, resources and changeovers precomputed
+struct AthleteDay {
+    vector<double> durations;
+    vector<vector<int>> resources;   // Indices into FloorProblem::resources
+    vector<vector<double>> changeover;
+    double total;
+};
+
+// Struct to hold a whole scheduling problem in index form
+struct FloorProblem {
+    vector<string> resources;
+    vector<int> capacity;
+    vector<AthleteDay> athletes;
+    double lower_bound;
+};
+
+// Function to describe the floor format.cpp prints: one of each station, cable and upright
+GymFloor default_gym_floor() {
+    GymFloor floor;
+    for (const char* resource : {"Squat Rack", "Bench Press Station", "Leg Extension Machine", "Leg Curl Machine",
+                                   "Center Upright", "Left Cable", "Right Cable", "Pulldown Cable"}) {
+        floor.capacity[resource] = 1;
+    }
+    return floor;
+}
+
+// Function to list the floor resources a structure holds while it is performed. A cable set to
+// "Both Cables" holds the left and right cable; any apparatus sits on the center upright.
+vector<string> structure_resources(const Structure& structure) {
+    vector<string> resources;
+    auto add = [&](const string& resource) {
+        if (find(resources.begin(), resources.end(), resource) == resources.end()) resources.push_back(resource);
+    };
+    for (const auto& exercise : structure.exercises) {
+        Equipment equipment = exercise_equipment(exercise);
+        if (equipment.cable.rfind("Both Cables", 0) == 0) {
+            add("Left Cable");
+            add("Right Cable");
+        } else if (equipment.cable.rfind("Left Cable", 0) == 0) {
+            add("Left Cable");
+        } else if (equipment.cable != "None") {
+            add(equipment.cable);
+        }
+        if (equipment.apparatus != "None") add("Center Upright");
+        if (equipment.station != "None") add(equipment.station);
+    }
+    return resources;
+}
+
+// Function to convert athletes and floor into index form and bound the makespan from below by
+// the longest athlete and the busiest resource per unit
+static FloorProblem make_floor_problem(const vector<vector<Structure>>& athletes, const GymFloor& floor) {
+    FloorProblem problem;
+    unordered_map<string, int> index;
+    vector<double> load;
+    double longest = 0.0;
+    for (const auto& day : athletes) {
+        AthleteDay athlete;
+        athlete.total = 0.0;
+        for (const auto& structure : day) {
+            double duration = calculate_time(structure.exercises, structure.sets);
+            vector<int> held;
+            for (const auto& resource : structure_resources(structure)) {
+                auto [it, inserted] = index.emplace(resource, static_cast<int>(problem.resources.size()));
+                if (inserted) {
+                    problem.resources.push_back(resource);
+                    auto cap = floor.capacity.find(resource);
+                    problem.capacity.push_back(cap == floor.capacity.end() ? 1 : max(1, cap->second));
+                    load.push_back(0.0);
+                }
+                held.push_back(it->second);
+                load[it->second] += duration;
+            }
+            athlete.durations.push_back(duration);
+            athlete.resources.push_back(held);
+            athlete.total += duration;
+        }
+        size_t n = day.size();
+        athlete.changeover.assign(n, vector<double>(n, 0.0));
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                if (i != j) athlete.changeover[i][j] = structure_changeover_time(day[i], day[j]);
+            }
+        }
+        longest = max(longest, athlete.total);
+        problem.athletes.push_back(athlete);
+    }
+    problem.lower_bound = longest;
+    for (size_t r = 0; r < load.size(); ++r) {
+        problem.lower_bound = max(problem.lower_bound, load[r] / problem.capacity[r]);
+    }
+    return problem;
+}
+
+// Function to find the earliest start at or after "from" where one unit's busy intervals leave a
+// gap of the given length
+static double earliest_on_unit(const vector<pair<double, double>>& busy, double from, double duration) {
+    double start = from;
+    for (const auto& [begin, end] : busy) {
+        if (end <= start) continue;
+        if (begin >= start + duration) break;
+        start = end;
+    }
+    return start;
+}
+
+// Function to decode an athlete priority order into a schedule. Athletes take turns by when they
+// are next free (ties go to the earlier athlete in the order); each starts its compound first and
+// then whichever remaining structure can begin soonest, on the first free unit of every resource.
+static FloorSchedule decode_order(const FloorProblem& problem, const vector<int>& order) {
+    vector<vector<vector<pair<double, double>>>> units(problem.resources.size());
+    for (size_t r = 0; r < units.size(); ++r) units[r].resize(problem.capacity[r]);
+
+    auto earliest_start = [&](const vector<int>& held, double from, double duration) {
+        double start = from;
+        bool moved = true;
+        while (moved) {
+            moved = false;
+            for (int r : held) {
+                double best = numeric_limits<double>::max();
+                for (const auto& busy : units[r]) best = min(best, earliest_on_unit(busy, start, duration));
+                if (best > start) {
+                    start = best;
+                    moved = true;
+                }
+            }
+        }
+        return start;
+    };
+
+    FloorSchedule schedule;
+    vector<int> rank(order.size());
+    for (size_t i = 0; i < order.size(); ++i) rank[order[i]] = static_cast<int>(i);
+    vector<vector<bool>> done(problem.athletes.size());
+    vector<int> previous(problem.athletes.size(), -1);
+    priority_queue<tuple<double, int, int>, vector<tuple<double, int, int>>, greater<tuple<double, int, int>>> ready;
+    for (size_t a = 0; a < problem.athletes.size(); ++a) {
+        done[a].assign(problem.athletes[a].durations.size(), false);
+        if (!done[a].empty()) ready.push({0.0, rank[a], static_cast<int>(a)});
+    }
+    while (!ready.empty()) {
+        auto [free_at, athlete_rank, a] = ready.top();
+        ready.pop();
+        const AthleteDay& athlete = problem.athletes[a];
+        int chosen = -1;
+        double chosen_start = numeric_limits<double>::max();
+        for (size_t s = 0; s < athlete.durations.size(); ++s) {
+            if (done[a][s]) continue;
+            double from = free_at + (previous[a] < 0 ? 0.0 : athlete.changeover[previous[a]][s]);
+            double start = earliest_start(athlete.resources[s], from, athlete.durations[s]);
+            if (start < chosen_start) {
+                chosen = static_cast<int>(s);
+                chosen_start = start;
+            }
+            if (previous[a] < 0) break;  // Compound first
+        }
+        double end = chosen_start + athlete.durations[chosen];
+        FloorAssignment assignment{a, chosen, chosen_start, end, {}};
+        for (int r : athlete.resources[chosen]) {
+            for (size_t u = 0; u < units[r].size(); ++u) {
+                auto& busy = units[r][u];
+                if (earliest_on_unit(busy, chosen_start, athlete.durations[chosen]) != chosen_start) continue;
+                busy.insert(lower_bound(busy.begin(), busy.end(), make_pair(chosen_start, end)), {chosen_start, end});
+                assignment.units.push_back(problem.resources[r] + " " + to_string(u + 1));
+                break;
+            }
+        }
+        schedule.assignments.push_back(assignment);
+        schedule.makespan = max(schedule.makespan, end);
+        done[a][chosen] = true;
+        previous[a] = chosen;
+        if (find(done[a].begin(), done[a].end(), false) != done[a].end()) ready.push({end, athlete_rank, a});
+    }
+    schedule.lower_bound = problem.lower_bound;
+    return schedule;
+}
+
+// Function to improve one starting order by swapping athletes, keeping swaps that do not lengthen
+// the session
+static FloorSchedule improve_order(const FloorProblem& problem, vector<int> order, int iterations, mt19937& gen) {
+    FloorSchedule best = decode_order(problem, order);
+    if (order.size() < 2) return best;
+    uniform_int_distribution<> position(0, static_cast<int>(order.size()) - 1);
+    for (int iteration = 0; iteration < iterations && best.makespan > problem.lower_bound; ++iteration) {
+        int i = position(gen);
+        int j = position(gen);
+        if (i == j) continue;
+        swap(order[i], order[j]);
+        FloorSchedule candidate = decode_order(problem, order);
+        if (candidate.makespan <= best.makespan) best = candidate;
+        else swap(order[i], order[j]);
+    }
+    return best;
+}
+
+// Function to schedule a group session: every athlete's day on a shared floor so that no resource
+// unit is double-booked, minimizing the makespan. Starting orders (longest athlete first, then
+// seeded shuffles) are improved independently on worker threads; each uses its own seed, so the
+// result does not depend on the thread count.
+FloorSchedule schedule_floor(const vector<vector<Structure>>& athletes, const GymFloor& floor, const FloorSearchOptions& options) {
+    FloorProblem problem = make_floor_problem(athletes, floor);
+    int orderings = max(1, options.orderings);
+    vector<FloorSchedule> results(orderings);
+    atomic<int> next(0);
+    auto worker = [&]() {
+        for (int k = next++; k < orderings; k = next++) {
+            vector<int> order(athletes.size());
+            iota(order.begin(), order.end(), 0);
+            mt19937 gen(options.seed + k);
+            if (k == 0) {
+                stable_sort(order.begin(), order.end(), [&](int a, int b) {
+                    return problem.athletes[a].total > problem.athletes[b].total;
+                });
+            } else {
+                shuffle(order.begin(), order.end(), gen);
+            }
+            results[k] = improve_order(problem, order, options.iterations, gen);
+        }
+    };
+    int threads = options.threads > 0 ? options.threads : max(1u, thread::hardware_concurrency());
+    threads = min(threads, orderings);
+    vector<thread> pool;
+    for (int t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+
+    size_t best = 0;
+    for (size_t k = 1; k < results.size(); ++k) {
+        if (results[k].makespan < results[best].makespan) best = k;
+    }
+    return results[best];
+}
+
+// Function to check a floor schedule: every structure placed once with its own duration, compound
+// first, no athlete in two places (changeovers included) and no resource unit double-booked;
+// returns one message per violation
+vector<string> check_floor_schedule(const vector<vector<Structure>>& athletes, const GymFloor& floor, const FloorSchedule& schedule) {
+    vector<string> violations;
+    vector<vector<const FloorAssignment*>> by_athlete(athletes.size());
+    unordered_map<string, vector<pair<double, double>>> by_unit;
+    for (const auto& assignment : schedule.assignments) {
+        string label = "Athlete " + to_string(assignment.athlete + 1);
+        if (assignment.athlete < 0 || assignment.athlete >= static_cast<int>(athletes.size()) ||
+            assignment.structure < 0 || assignment.structure >= static_cast<int>(athletes[assignment.athlete].size())) {
+            violations.push_back(label + ": unknown structure " + to_string(assignment.structure));
+            continue;
+        }
+        const Structure& structure = athletes[assignment.athlete][assignment.structure];
+        by_athlete[assignment.athlete].push_back(&assignment);
+        if (abs(assignment.end - assignment.start - calculate_time(structure.exercises, structure.sets)) > 1e-9) {
+            violations.push_back(label + ": \"" + join(structure.exercises, ", ") + "\" has the wrong duration");
+        }
+        for (const auto& resource : structure_resources(structure)) {
+            auto cap = floor.capacity.find(resource);
+            int capacity = cap == floor.capacity.end() ? 1 : max(1, cap->second);
+            bool held = false;
+            for (int u = 1; u <= capacity; ++u) held = held || count(assignment.units.begin(), assignment.units.end(), resource + " " + to_string(u));
+            if (!held) violations.push_back(label + ": \"" + join(structure.exercises, ", ") + "\" holds no " + resource);
+        }
+        for (const auto& unit : assignment.units) by_unit[unit].push_back({assignment.start, assignment.end});
+    }
+    for (size_t a = 0; a < athletes.size(); ++a) {
+        string label = "Athlete " + to_string(a + 1);
+        auto& placed = by_athlete[a];
+        if (placed.size() != athletes[a].size()) {
+            violations.push_back(label + ": " + to_string(placed.size()) + " of " + to_string(athletes[a].size()) + " structures placed");
+        }
+        sort(placed.begin(), placed.end(), [](const FloorAssignment* x, const FloorAssignment* y) { return x->start < y->start; });
+        if (!placed.empty() && placed[0]->structure != 0) violations.push_back(label + ": compound not first");
+        for (size_t i = 1; i < placed.size(); ++i) {
+            double gap = structure_changeover_time(athletes[a][placed[i - 1]->structure], athletes[a][placed[i]->structure]);
+            if (placed[i]->start < placed[i - 1]->end + gap - 1e-9) violations.push_back(label + ": overlapping structures");
+        }
+    }
+    for (auto& [unit, busy] : by_unit) {
+        sort(busy.begin(), busy.end());
+        for (size_t i = 1; i < busy.size(); ++i) {
+            if (busy[i].first < busy[i - 1].second - 1e-9) violations.push_back(unit + ": double-booked at " + to_string(busy[i].first));
+        }
+    }
+    return violations;
+}
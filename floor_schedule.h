@@ -0,0 +1,43 @@
+#ifndef FLOOR_SCHEDULE_H
+#define FLOOR_SCHEDULE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "exercise_definitions.h"
+
+// Struct to hold how many of each floor resource the gym has (resources not listed have one)
+struct GymFloor {
+    std::unordered_map<std::string, int> capacity;
+};
+
+// Struct to hold one structure of one athlete placed on the floor
+struct FloorAssignment {
+    int athlete;
+    int structure;                   // Index into the athlete's day
+    double start;                    // Minutes from the start of the session
+    double end;
+    std::vector<std::string> units;  // Resource units held, e.g. "Squat Rack 2"
+};
+
+// Struct to hold a floor schedule for a group session
+struct FloorSchedule {
+    std::vector<FloorAssignment> assignments;
+    double makespan = 0.0;
+    double lower_bound = 0.0;
+};
+
+// Struct to hold the search settings for schedule_floor
+struct FloorSearchOptions {
+    unsigned int seed = 1;
+    int orderings = 32;    // Athlete orderings searched from (each improved independently)
+    int iterations = 200;  // Swap moves tried per ordering
+    int threads = 0;       // 0 = one per hardware thread
+};
+
+GymFloor default_gym_floor();
+std::vector<std::string> structure_resources(const Structure& structure);
+FloorSchedule schedule_floor(const std::vector<std::vector<Structure>>& athletes, const GymFloor& floor, const FloorSearchOptions& options = {});
+std::vector<std::string> check_floor_schedule(const std::vector<std::vector<Structure>>& athletes, const GymFloor& floor, const FloorSchedule& schedule);
+
+#endif // FLOOR_SCHEDULE_H
@@ -1,6 +1,7 @@
 #include "format.h"
 #include "volume.h"
 #include "utils.h"
+#include "equipment.h"
 #include <iostream>  // For cout
 #include <limits>    // For numeric_limits
 #include <iomanip>
@@ -26,7 +27,7 @@ string format_routine(
         }
         markdown += "## Day " + to_string(day) + ": " + day_name + " – " + to_string(total_exercises) + " Exercises\n";
         for (size_t i = 0; i < structures.size(); ++i) {
-            string structure_type = "Straight Sets";
+            string structure_type = structure_type_name(structures[i].exercises.size()) + "s";
             if (i == 0) structure_type += " (Compound First)";
             markdown += "- **" + structure_type + "**:  \n";
             for (const auto& exercise : structures[i].exercises) {
@@ -53,35 +54,19 @@ string format_routine(
                 if (!ex.secondary.empty()) muscles += ", secondary: " + join(secondary_cleaned, ", ");
                 if (!ex.isometric.empty()) muscles += ", isometric: " + join(isometric_cleaned, ", ");
                 markdown += "  - " + exercise + " - " + to_string(structures[i].sets) + " sets of 8-12 reps *(" + muscles + ")*  \n";
-                string cable = "None";
-                if (exercise.find("Cable") != string::npos) {
-                    if (exercise == "Cable Curl") cable = "Left Cable, Low Height";
-                    else if (exercise == "Pulldown") cable = "Pulldown Cable";
-                    else if (exercise == "Chest Fly") cable = "Both Cables, Medium Height";
-                    else cable = "Left Cable, High Height";
-                }
-                string apparatus = "None";
-                if (exercise.find("Bench Press") != string::npos) apparatus = "Bench on Center Upright, Low";
-                else if (exercise == "Upper Back Rows") apparatus = "Bulldog Pad on Center Upright, High";
-                string station = "None";
-                if (exercise.find("Bench Press") != string::npos) station = "Bench Press Station";
-                else if (exercise == "Squat") station = "Squat Rack";
-                else if (exercise == "Leg Extension") station = "Leg Extension Machine";
-                else if (exercise == "Leg Curl") station = "Leg Curl Machine";
-                markdown += "  *(Attributes: Cable: " + cable + "; Apparatus: " + apparatus + "; Station: " + station + ")*  \n";
+                Equipment equipment = exercise_equipment(exercise);
+                markdown += "  *(Attributes: Cable: " + equipment.cable + "; Apparatus: " + equipment.apparatus + "; Station: " + equipment.station + ")*  \n";
             }
         }
-        double total_time = 0;
-        for (const auto& structure : structures) {
-            total_time += calculate_time(structure.exercises, structure.sets);
-        }
+        double total_time = day_time(structures);
         markdown += "- **Time Estimate**:  \n";
         for (const auto& structure : structures) {
-            string structure_type = "Straight Set";
+            string structure_type = structure_type_name(structure.exercises.size());
             string structure_name = "\"" + join(structure.exercises, ", ") + "\"";
             double time = calculate_time(structure.exercises, structure.sets);
             markdown += "  - " + structure_type + " " + structure_name + ": " + to_string(time) + " min  \n";
         }
+        markdown += "  - Equipment changeovers: " + to_string(day_changeover_time(structures)) + " min  \n";
         markdown += "  - **Total**: " + to_string(total_time) + " minutes  \n\n";
     }
 
@@ -95,12 +80,11 @@ string format_routine(
         if (muscle_group == "Glutes" || muscle_group == "Lower Back") {
             status = "reported for information only, not optimized per user instruction";
         } else {
-            if (vol == target) status = "exactly on target";
-            else if (vol > target) status = "exceeds low end due to time balancing, acceptable per rule";
+            if (vol == target.target) status = "exactly on target";
+            else if (vol > target.target) status = "exceeds low end due to time balancing, acceptable per rule";
             else status = "below target";
         }
-        int upper_bound = (muscle_group == "Glutes" || muscle_group == "Lower Back") ? target + 8 : target + 6;
-        markdown += "- **" + muscle_group + "**: " + to_string(vol) + " sets  \n  *(MAV: " + to_string(target) + "-" + to_string(upper_bound) + " sets – " + status + ")*  \n";
+        markdown += "- **" + muscle_group + "**: " + to_string(vol) + " sets  \n  *(MAV: " + to_string(target.target) + "-" + to_string(target.upper_bound) + " sets – " + status + ")*  \n";
     }
 
     // Muscle Activation Table with aligned columns
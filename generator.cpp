@@ -0,0 +1,517 @@
+#include "generator.h"
+#include "utils.h"
+#include "constraints.h"
+#include "volume.h"
+#include "assign.h"
+#include "structures.h"
+#include "equipment.h"
+#include "set_allocation.h"
+#include <iostream>
+#include <unordered_set>
+#include <algorithm>
+#include <limits>
+#include <queue>
+
+using namespace std;
+
+// Function to choose every structure's sets for the exercises already placed (see
+// solve_set_allocation: exact per day, coordinate descent across days), scoring volume as volume_deficit_cost does and keeping days in time
+static void allocate_structure_sets(unordered_map<int, vector<Structure>>& routine, unordered_map<int, double>& day_times,
+                                    const unordered_map<string, Exercise>& exercises_map) {
+    SetAllocationProblem problem;
+    vector<string> muscles;
+    for (const auto& [muscle, target] : mav_targets) muscles.push_back(muscle);
+    sort(muscles.begin(), muscles.end());
+    problem.muscles = muscles.size();
+    for (const auto& muscle : muscles) {
+        double weight = (muscle == "Glutes" || muscle == "Lower Back") ? 0.0 : 1.0;
+        problem.targets.push_back(mav_targets.at(muscle).target);
+        problem.upper_bounds.push_back(mav_targets.at(muscle).upper_bound);
+        problem.deficit_weights.push_back(weight);
+        problem.excess_weights.push_back(weight);
+    }
+    problem.min_sets = MIN_SETS;
+    problem.max_sets = MAX_SETS;
+    problem.max_day_time = MAX_TIME_PER_DAY;
+
+    vector<pair<int, size_t>> positions;   // (day, structure) of each item
+    vector<int> sets;
+    for (int day = 1; day <= TOTAL_DAYS; ++day) {
+        problem.day_items.emplace_back();
+        problem.day_fixed_times.push_back(day_changeover_time(routine[day]));
+        for (size_t i = 0; i < routine[day].size(); ++i) {
+            unordered_map<int, vector<Structure>> one_set = {{day, {{routine[day][i].exercises, 1}}}};
+            unordered_map<string, double> per_set = calculate_volume(one_set, exercises_map);
+            problem.day_items.back().push_back(positions.size());
+            for (const auto& muscle : muscles) problem.item_volumes.push_back(per_set.count(muscle) ? per_set[muscle] : 0.0);
+            problem.item_times.push_back(calculate_time(routine[day][i].exercises, 1));
+            positions.push_back({day, i});
+            sets.push_back(routine[day][i].sets);
+        }
+    }
+
+    double before = volume_deficit_cost(routine, exercises_map);
+    solve_set_allocation(problem, sets);
+    for (size_t item = 0; item < positions.size(); ++item) routine[positions[item].first][positions[item].second].sets = sets[item];
+    for (int day = 1; day <= TOTAL_DAYS; ++day) day_times[day] = day_time(routine[day]);
+    cout << "Set allocation: volume cost " << before << " -> " << volume_deficit_cost(routine, exercises_map) << "\n";
+}
+
+// Struct to hold a muscle's entry in the volume balancer's heap: how far its volume lies outside
+// the MAV range (entries made stale by later changes are skipped)
+struct VolumeImbalance {
+    double amount;
+    size_t muscle;
+    bool operator<(const VolumeImbalance& other) const { return amount < other.amount; }
+};
+
+// Function to balance weekly volume one set at a time. Muscles outside their MAV range (Glutes
+// and Lower Back excluded) wait in a max-heap keyed by the distance. The worst one takes the
+// single-set change that lowers volume_deficit_cost the most: +1 set on a structure that works it
+// when short, -1 when over. Only the muscles that change touches are re-keyed. A muscle with no
+// improving change leaves the heap until another change touches it, and balancing ends when the
+// heap is empty. Sets stay in [MIN_SETS, MAX_SETS], days stay within MAX_TIME_PER_DAY, and sets are
+// only added where the lead exercise's primary muscles rested the previous day.
+static void balance_volumes(unordered_map<int, vector<Structure>>& routine, unordered_map<int, double>& day_times,
+                            const unordered_map<int, vector<string>>& days, const unordered_map<string, Exercise>& exercises_map) {
+    vector<string> muscles;
+    for (const auto& [muscle, target] : mav_targets) muscles.push_back(muscle);
+    sort(muscles.begin(), muscles.end());
+    unordered_map<string, size_t> column;
+    for (size_t m = 0; m < muscles.size(); ++m) column[muscles[m]] = m;
+    unordered_map<string, double> initial_volume = calculate_volume(routine, exercises_map);
+    vector<double> volume(muscles.size(), 0.0);
+    for (const auto& [muscle, vol] : initial_volume) {
+        if (column.count(muscle)) volume[column[muscle]] += vol;
+    }
+    auto balanced = [&](size_t m) { return muscles[m] != "Glutes" && muscles[m] != "Lower Back"; };
+    auto muscle_cost = [&](size_t m, double vol) {
+        const MuscleGroup& target = mav_targets.at(muscles[m]);
+        if (!balanced(m)) return 0.0;
+        if (vol < target.target) return (target.target - vol) * (target.target - vol);
+        if (vol > target.upper_bound) return (vol - target.upper_bound) * (vol - target.upper_bound);
+        return 0.0;
+    };
+    auto imbalance = [&](size_t m) {
+        const MuscleGroup& target = mav_targets.at(muscles[m]);
+        if (!balanced(m)) return 0.0;
+        return max(0.0, max(target.target - volume[m], volume[m] - target.upper_bound));
+    };
+
+    // Each structure's per-set volume over the muscles it works, and whether sets may be added
+    struct BalancerSlot {
+        int day;
+        size_t index;
+        vector<pair<size_t, double>> per_set;
+        double set_time;
+        bool rested;
+    };
+    vector<BalancerSlot> slots;
+    vector<vector<size_t>> slots_for_muscle(muscles.size());
+    for (int day = 1; day <= TOTAL_DAYS; ++day) {
+        unordered_set<string> previous_day_muscles;
+        auto previous = days.find(day - 1);
+        if (previous != days.end()) {
+            for (const auto& exercise : previous->second) {
+                const Exercise& ex = exercises_map.at(exercise);
+                previous_day_muscles.insert(ex.primary.begin(), ex.primary.end());
+                previous_day_muscles.insert(ex.secondary.begin(), ex.secondary.end());
+                previous_day_muscles.insert(ex.isometric.begin(), ex.isometric.end());
+            }
+        }
+        for (size_t i = 0; i < routine[day].size(); ++i) {
+            const Structure& structure = routine[day][i];
+            BalancerSlot slot{day, i, {}, calculate_time(structure.exercises, 1), true};
+            unordered_map<int, vector<Structure>> one_set = {{day, {{structure.exercises, 1}}}};
+            for (const auto& [muscle, vol] : calculate_volume(one_set, exercises_map)) {
+                if (column.count(muscle)) slot.per_set.push_back({column[muscle], vol});
+            }
+            for (const auto& muscle : exercises_map.at(structure.exercises[0]).primary) {
+                if (previous_day_muscles.count(muscle)) slot.rested = false;
+            }
+            for (const auto& [m, vol] : slot.per_set) slots_for_muscle[m].push_back(slots.size());
+            slots.push_back(slot);
+        }
+    }
+
+    priority_queue<VolumeImbalance> heap;
+    for (size_t m = 0; m < muscles.size(); ++m) {
+        if (imbalance(m) > 0) heap.push({imbalance(m), m});
+    }
+    int changes = 0;
+    while (!heap.empty()) {
+        VolumeImbalance top = heap.top();
+        heap.pop();
+        size_t m = top.muscle;
+        if (top.amount != imbalance(m)) continue;
+        int direction = volume[m] < mav_targets.at(muscles[m]).target ? 1 : -1;
+        const BalancerSlot* best = nullptr;
+        double best_delta = -1e-9;  // A change must strictly improve the cost
+        for (size_t index : slots_for_muscle[m]) {
+            const BalancerSlot& slot = slots[index];
+            int sets = routine[slot.day][slot.index].sets;
+            if (direction > 0 && (sets >= MAX_SETS || !slot.rested || day_times[slot.day] + slot.set_time > MAX_TIME_PER_DAY)) continue;
+            if (direction < 0 && sets <= MIN_SETS) continue;
+            double delta = 0.0;
+            for (const auto& [muscle, vol] : slot.per_set) {
+                delta += muscle_cost(muscle, volume[muscle] + direction * vol) - muscle_cost(muscle, volume[muscle]);
+            }
+            if (delta < best_delta) {
+                best_delta = delta;
+                best = &slot;
+            }
+        }
+        if (!best) {
+            cout << "  No improving set change for " << muscles[m] << " (volume: " << volume[m] << ")\n";
+            continue;
+        }
+        Structure& structure = routine[best->day][best->index];
+        structure.sets += direction;
+        day_times[best->day] += direction * best->set_time;
+        for (const auto& [muscle, vol] : best->per_set) {
+            volume[muscle] += direction * vol;
+            if (imbalance(muscle) > 0) heap.push({imbalance(muscle), muscle});
+        }
+        ++changes;
+        cout << "  " << (direction > 0 ? "Added" : "Removed") << " 1 set " << (direction > 0 ? "to" : "from") << " [\"" << structure.exercises[0]
+             << "\"] on Day " << best->day << " for " << muscles[m] << ". New volume: " << volume[m] << "\n";
+    }
+    cout << "Volume balancing made " << changes << " set changes.\n";
+}
+
+// Function to generate a routine with the greedy assignment and volume balancing pipeline
+void generate_routine(
+    mt19937& g,
+    unordered_map<int, vector<Structure>>& routine,
+    unordered_map<int, double>& day_times
+) {
+    // Create a map for quick lookup
+    unordered_map<string, Exercise> exercises_map;
+    for (const auto& ex : exercises) {
+        exercises_map[ex.name] = ex;
+    }
+
+    // Initialize days and usage tracking
+    unordered_map<int, vector<string>> days;
+    for (int i = 1; i <= 6; ++i) days[i] = vector<string>();
+    unordered_map<string, int> exercise_usage;
+    for (const auto& ex : exercises) {
+        exercise_usage[ex.name] = 0;
+    }
+    unordered_map<string, double> muscle_coverage;
+    unordered_map<string, int> last_worked_day;  // Track the last day each muscle group was worked
+
+    // Precompute exercise contributions
+    unordered_map<string, unordered_map<string, double>> exercise_contributions;
+    for (size_t i = 0; i < exercises.size(); ++i) {
+        unordered_map<string, double> contrib;
+        const auto& ex = exercises[i];
+        for (const auto& muscle : ex.primary) contrib[muscle] = 1.0;
+        for (const auto& muscle : ex.secondary) contrib[muscle] = 0.25;
+        for (const auto& muscle : ex.isometric) contrib[muscle] = 0.25;
+        exercise_contributions[ex.name] = contrib;
+    }
+
+    // Target number of exercises per day
+    const int target_exercises_per_day = 4;
+    const int max_exercises_per_day = 6;  // Constraint: 3-6 exercises per day
+    const int total_days = 6;
+    const double max_time_per_day = 50.0;  // Max time per day
+
+    // Calculate target muscle group coverage (excluding Glutes and Lower Back)
+    unordered_map<string, double> target_coverage;
+    unordered_map<string, double> target_upper_bounds;
+    for (const auto& [muscle, target] : mav_targets) {
+        if (muscle == "Glutes" || muscle == "Lower Back") continue;
+        target_coverage[muscle] = target.target / static_cast<double>(total_days);
+        target_upper_bounds[muscle] = target.upper_bound;  // Upper bound for volume
+    }
+    cout << "Target muscle group coverage per day (excluding Glutes and Lower Back):\n";
+    for (const auto& [muscle, target] : target_coverage) {
+        cout << "  " << muscle << ": " << target << " sets\n";
+    }
+
+    // Assign exercises
+    assign_exercises(
+        days,
+        exercise_usage,
+        muscle_coverage,
+        last_worked_day,
+        exercise_contributions,
+        exercises_map,
+        day_times,
+        target_coverage,
+        exercises,
+        target_exercises_per_day,
+        total_days,
+        g,
+        routine
+    );
+
+    // Set structure generation: pair compatible, non-synergistic exercises into supersets/tri-sets
+    cout << "Generating initial set structures for time estimation...\n";
+    CompatibilityMatrix compatibility = build_compatibility_matrix(exercises, compatible_pairs);
+    for (int day = 1; day <= total_days; ++day) {
+        vector<Structure>& routine_structures = routine[day];
+        routine_structures = build_day_structures(days[day], compatibility, 3);  // Start with 3 sets
+        order_day_structures(routine_structures);
+        day_times[day] = day_time(routine_structures);  // Sets plus equipment changeovers
+    }
+
+    // Ensure no day exceeds 50 minutes (only reduction if necessary, no balancing)
+    for (int day = 1; day <= total_days; ++day) {
+        int inner_iteration = 0;
+        const int max_inner_iterations = 10;
+        while (day_times[day] > max_time_per_day && inner_iteration < max_inner_iterations) {
+            cout << "  Reducing time for Day " << day << " (current: " << day_times[day] << ", max: " << max_time_per_day << ")\n";
+            for (auto& structure : routine[day]) {
+                if (structure.sets <= 2) continue;
+                --structure.sets;
+                day_times[day] -= calculate_time(structure.exercises, 1);
+                cout << "    Reduced 1 set from [\"" << structure.exercises[0] << "\"] on Day " << day << "\n";
+                break;
+            }
+            inner_iteration++;
+        }
+        if (inner_iteration >= max_inner_iterations) {
+            cout << "  Warning: Max inner iterations reached while reducing time for Day " << day << "\n";
+        }
+    }
+
+    // Balance volumes toward the MAV ranges one set at a time
+    cout << "Optimizing volumes...\n";
+    balance_volumes(routine, day_times, days, exercises_map);
+
+    // Final pass: Add exercises to days to maximize volume for remaining deficits
+    cout << "Final pass: Adding exercises to maximize volume...\n";
+    auto current_volume = calculate_volume(routine, exercises_map);
+    vector<pair<string, double>> final_deficits;
+    for (const auto& [muscle_group, target] : mav_targets) {
+        if (muscle_group == "Glutes" || muscle_group == "Lower Back") continue;
+        double deficit = target.target - current_volume[muscle_group];
+        if (deficit > 0) {
+            final_deficits.emplace_back(muscle_group, deficit);
+        }
+    }
+    sort(final_deficits.begin(), final_deficits.end(), 
+         [](const auto& a, const auto& b) { return a.second > b.second; });
+
+    for (const auto& [muscle_group, deficit] : final_deficits) {
+        if (deficit <= 0) continue;
+        cout << "  Final pass for " << muscle_group << " (deficit: " << deficit << ")\n";
+        vector<string> contributing_exercises;
+        for (const auto& ex : exercises) {
+            bool contributes = false;
+            for (const auto& muscle : ex.primary) {
+                string base_muscle = muscle.substr(0, muscle.find(" ("));
+                if (base_muscle == muscle_group) { contributes = true; break; }
+            }
+            for (const auto& muscle : ex.secondary) {
+                string base_muscle = muscle.substr(0, muscle.find(" ("));
+                if (base_muscle == muscle_group) { contributes = true; break; }
+            }
+            for (const auto& muscle : ex.isometric) {
+                string base_muscle = muscle.substr(0, muscle.find(" ("));
+                if (base_muscle == muscle_group) { contributes = true; break; }
+            }
+            if (contributes) contributing_exercises.push_back(ex.name);
+        }
+        if (contributing_exercises.empty()) continue;
+
+        // Days are tried in a fresh shuffle per deficit muscle, so which day takes an exercise
+        // (and which days recovery then blocks) depends on how many deficits came before it
+        vector<int> days_list(total_days);
+        for (int d = 1; d <= total_days; ++d) days_list[d-1] = d;
+        shuffle(days_list.begin(), days_list.end(), g);
+
+        for (int day : days_list) {
+            double current_day_time = day_times[day];
+            if (current_day_time >= max_time_per_day) continue;
+
+            // Check if adding a new exercise is feasible
+            bool can_add_exercise = true;
+            vector<string> current_exercises;
+            for (const auto& structure : routine[day]) {
+                current_exercises.insert(current_exercises.end(), structure.exercises.begin(), structure.exercises.end());
+            }
+            if (current_exercises.size() >= max_exercises_per_day) continue;
+            int current_leg_exercises = 0;
+            for (const auto& ex : current_exercises) {
+                if (exercises_map.at(ex).is_leg) ++current_leg_exercises;
+            }
+
+            string best_exercise;
+            double best_volume_score = numeric_limits<double>::lowest();
+            for (const auto& ex : contributing_exercises) {
+                // Skip if exercise is already in the day
+                if (find(current_exercises.begin(), current_exercises.end(), ex) != current_exercises.end()) continue;
+
+                // Check leg exercise constraint
+                bool is_leg = exercises_map.at(ex).is_leg;
+                if (is_leg && current_leg_exercises >= 1) continue;  // Only one leg exercise per day
+
+                // Check recovery
+                bool can_use = true;
+                unordered_set<string> exercise_muscles;
+                unordered_set<string> primary_muscles;
+                for (const auto& muscle : exercises_map.at(ex).primary) {
+                    exercise_muscles.insert(muscle);
+                    primary_muscles.insert(muscle);
+                    if (!can_work_muscle(muscle, day, last_worked_day)) {
+                        can_use = false;
+                        break;
+                    }
+                }
+                for (const auto& muscle : exercises_map.at(ex).secondary) {
+                    exercise_muscles.insert(muscle);
+                    if (!can_work_muscle(muscle, day, last_worked_day)) {
+                        can_use = false;
+                        break;
+                    }
+                }
+                for (const auto& muscle : exercises_map.at(ex).isometric) {
+                    exercise_muscles.insert(muscle);
+                    if (!can_work_muscle(muscle, day, last_worked_day)) {
+                        can_use = false;
+                        break;
+                    }
+                }
+                if (!can_use) continue;
+
+                // Calculate volume contribution
+                double volume_score = 0;
+                for (const auto& [muscle, target] : target_coverage) {
+                    double current = current_volume[muscle];
+                    double diff = target - current;
+                    if (diff > 0) {
+                        bool contributes = false;
+                        double contribution = 0;
+                        for (const auto& m : exercises_map.at(ex).primary) {
+                            string base_muscle = m.substr(0, m.find(" ("));
+                            if (base_muscle == muscle) {
+                                contributes = true;
+                                contribution += 1.0;
+                                break;
+                            }
+                        }
+                        for (const auto& m : exercises_map.at(ex).secondary) {
+                            string base_muscle = m.substr(0, m.find(" ("));
+                            if (base_muscle == muscle) {
+                                contributes = true;
+                                contribution += 0.25;
+                                break;
+                            }
+                        }
+                        for (const auto& m : exercises_map.at(ex).isometric) {
+                            string base_muscle = m.substr(0, m.find(" ("));
+                            if (base_muscle == muscle) {
+                                contributes = true;
+                                contribution += 0.25;
+                                break;
+                            }
+                        }
+                        if (contributes) {
+                            volume_score -= diff * contribution * 200;
+                        }
+                    }
+                }
+                if (volume_score > best_volume_score) {
+                    best_volume_score = volume_score;
+                    best_exercise = ex;
+                }
+            }
+
+            if (best_exercise.empty()) continue;
+
+            // Add the exercise with maximum sets possible, after the changeovers it brings
+            vector<Structure> reordered = routine[day];
+            reordered.push_back({{best_exercise}, 0});
+            order_day_structures(reordered);
+            double changeover = day_changeover_time(reordered) - day_changeover_time(routine[day]);
+            int sets_to_add = min(5, static_cast<int>((max_time_per_day - current_day_time - changeover) / 2.0));
+            if (sets_to_add <= 0) continue;
+
+            for (auto& structure : reordered) {
+                if (structure.exercises == vector<string>{best_exercise}) structure.sets = sets_to_add;
+            }
+            routine[day] = reordered;
+            exercise_usage[best_exercise]++;
+            for (const auto& [muscle, contrib] : exercise_contributions.at(best_exercise)) {
+                muscle_coverage[muscle] += contrib * sets_to_add;
+                if (muscle_recovery_days.find(muscle) != muscle_recovery_days.end()) {
+                    last_worked_day[muscle] = day;
+                }
+            }
+            day_times[day] = day_time(routine[day]);
+            cout << "  Added " << best_exercise << " with " << sets_to_add << " sets to Day " << day << "\n";
+
+            // Recalculate volume for the next muscle group
+            current_volume = calculate_volume(routine, exercises_map);
+        }
+    }
+    cout << "Final volume optimization pass completed.\n";
+
+    // Finishing stage: with the exercises fixed, choose the set counts by per-day exact
+    // solves, with coordinate descent across days
+    allocate_structure_sets(routine, day_times, exercises_map);
+
+    cout << "Routine generation completed.\n";
+}
+
+// Function to score a generated routine by squared distance outside each muscle's MAV range
+// (Glutes and Lower Back are excluded, as in the volume optimization)
+double volume_deficit_cost(const unordered_map<int, vector<Structure>>& routine, const unordered_map<string, Exercise>& exercises_map) {
+    unordered_map<string, double> volume = calculate_volume(routine, exercises_map);
+    double cost = 0.0;
+    for (const auto& [muscle_group, target] : mav_targets) {
+        if (muscle_group == "Glutes" || muscle_group == "Lower Back") continue;
+        double vol = volume[muscle_group];
+        if (vol < target.target) cost += (target.target - vol) * (target.target - vol);
+        else if (vol > target.upper_bound) cost += (vol - target.upper_bound) * (vol - target.upper_bound);
+    }
+    return cost;
+}
+
+// Function to check a generated routine against the pipeline's rules; returns one message per violation
+vector<string> check_generated_routine(const unordered_map<int, vector<Structure>>& routine, const unordered_map<string, Exercise>& exercises_map) {
+    vector<string> violations;
+    unordered_map<string, int> last_worked_day;
+    for (int day = 1; day <= TOTAL_DAYS; ++day) {
+        string label = "Day " + to_string(day);
+        auto it = routine.find(day);
+        vector<Structure> structures = it == routine.end() ? vector<Structure>() : it->second;
+        unordered_set<string> day_exercises;
+        int leg_exercises = 0;
+        for (const auto& structure : structures) {
+            if (structure.sets < MIN_SETS || structure.sets > MAX_SETS) {
+                violations.push_back(label + ": \"" + join(structure.exercises, ", ") + "\" has " + to_string(structure.sets) + " sets");
+            }
+            for (const auto& exercise : structure.exercises) {
+                if (!day_exercises.insert(exercise).second) {
+                    violations.push_back(label + ": " + exercise + " repeated");
+                }
+                const auto& ex = exercises_map.at(exercise);
+                if (ex.is_leg) ++leg_exercises;
+                for (const auto& muscle : ex.primary) {
+                    if (!can_work_muscle(muscle, day, last_worked_day)) {
+                        violations.push_back(label + ": " + muscle + " not recovered for " + exercise);
+                    }
+                }
+            }
+        }
+        if (day_exercises.size() < MIN_EXERCISES_PER_DAY || day_exercises.size() > MAX_EXERCISES_PER_DAY) {
+            violations.push_back(label + ": " + to_string(day_exercises.size()) + " exercises");
+        }
+        if (leg_exercises > 2) {
+            violations.push_back(label + ": " + to_string(leg_exercises) + " leg exercises");
+        }
+        double time = day_time(structures);
+        if (time > MAX_TIME_PER_DAY) {
+            violations.push_back(label + ": " + to_string(time) + " minutes");
+        }
+        for (const auto& exercise : day_exercises) {
+            for (const auto& muscle : exercises_map.at(exercise).primary) last_worked_day[muscle] = day;
+        }
+    }
+    return violations;
+}
@@ -0,0 +1,18 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <vector>
+#include <unordered_map>
+#include <random>
+#include <string>
+#include "exercise_definitions.h"
+
+void generate_routine(
+    std::mt19937& g,
+    std::unordered_map<int, std::vector<Structure>>& routine,
+    std::unordered_map<int, double>& day_times
+);
+double volume_deficit_cost(const std::unordered_map<int, std::vector<Structure>>& routine, const std::unordered_map<std::string, Exercise>& exercises_map);
+std::vector<std::string> check_generated_routine(const std::unordered_map<int, std::vector<Structure>>& routine, const std::unordered_map<std::string, Exercise>& exercises_map);
+
+#endif // GENERATOR_H
@@ -0,0 +1,134 @@
+#include "genetic.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+
+// Function to cross two routines day by day: each day comes whole from one parent at random
+vector<vector<RoutineEntry>> day_crossover(const vector<vector<RoutineEntry>>& a, const vector<vector<RoutineEntry>>& b, mt19937& gen) {
+    vector<vector<RoutineEntry>> child(TOTAL_DAYS);
+    bernoulli_distribution from_a(0.5);
+    for (int day = 0; day < TOTAL_DAYS; ++day) child[day] = from_a(gen) ? a[day] : b[day];
+    return child;
+}
+
+// Function to cross two routines by muscle coverage: days are taken in a random order, each from
+// the parent whose day leaves the child's volume term lower given the days chosen so far
+// (deficit_weights as resolved by resolve_deficit_weights for mav_targets)
+vector<vector<RoutineEntry>> muscle_crossover(const vector<vector<RoutineEntry>>& a, const vector<vector<RoutineEntry>>& b,
+                                              const vector<Exercise>& exercises, const unordered_map<string, MuscleGroup>& mav_targets,
+                                              mt19937& gen, const OptimizerProfile* profile, const vector<double>& deficit_weights) {
+    double excess_weight = weights_for(profile).excess_volume;
+    vector<vector<RoutineEntry>> child(TOTAL_DAYS);
+    vector<int> days(TOTAL_DAYS);
+    for (int day = 0; day < TOTAL_DAYS; ++day) days[day] = day;
+    shuffle(days.begin(), days.end(), gen);
+    map<string, double> volumes;
+    for (int day : days) {
+        map<string, double> with_a = volumes;
+        map<string, double> with_b = volumes;
+        add_day_volumes(with_a, a[day], exercises, 1.0);
+        add_day_volumes(with_b, b[day], exercises, 1.0);
+        double penalty_a = volume_penalty(with_a, mav_targets, deficit_weights, excess_weight);
+        double penalty_b = volume_penalty(with_b, mav_targets, deficit_weights, excess_weight);
+        bool take_a = penalty_a < penalty_b || (penalty_a == penalty_b && bernoulli_distribution(0.5)(gen));
+        child[day] = take_a ? a[day] : b[day];
+        volumes = take_a ? with_a : with_b;
+    }
+    return child;
+}
+
+// Function to pick the lowest-cost of `size` individuals drawn at random
+static const Individual& tournament_select(const vector<Individual>& population, int size, mt19937& gen) {
+    uniform_int_distribution<> pick(0, static_cast<int>(population.size()) - 1);
+    const Individual* best = &population[pick(gen)];
+    for (int i = 1; i < size; ++i) {
+        const Individual& rival = population[pick(gen)];
+        if (rival.cost < best->cost) best = &rival;
+    }
+    return *best;
+}
+
+// Function to evolve routines: tournament selection, day-level or muscle-aware crossover, mutation
+// by perturb_routine moves, structural repair and elitism. Children are bred and costed on worker
+// threads; each child has its own seed drawn up front, so the result does not depend on the
+// thread count.
+vector<vector<RoutineEntry>> optimize_routine_genetic(const vector<Exercise>& exercises,
+                                                      const unordered_map<string, MuscleGroup>& mav_targets,
+                                                      const GeneticOptions& options,
+                                                      const OptimizerProfile* profile,
+                                                      ProgressObserver* progress) {
+    mt19937 gen(options.seed);
+    int size = max(2, options.population);
+    int elites = min(max(0, options.elites), size);
+    int threads = options.threads > 0 ? options.threads : max(1u, thread::hardware_concurrency());
+    auto by_cost = [](const Individual& x, const Individual& y) { return x.cost < y.cost; };
+    shared_ptr<CostTable> costs = make_cost_table();  // Shared by the workers; repeated children cost a lookup
+    vector<double> deficit_weights = resolve_deficit_weights(mav_targets, profile);
+
+    // Runs fill(i, child_gen) for every index in [first, size) across the worker threads
+    auto parallel_fill = [&](vector<Individual>& population, int first, auto fill) {
+        vector<unsigned int> seeds(size);
+        for (int i = first; i < size; ++i) seeds[i] = gen();
+        atomic<int> next(first);
+        auto worker = [&]() {
+            for (int i = next++; i < size; i = next++) {
+                mt19937 child_gen(seeds[i]);
+                population[i].routine = fill(child_gen);
+                population[i].cost = cached_cost(*costs, routine_hash(population[i].routine), population[i].routine, mav_targets, exercises, profile, deficit_weights);
+            }
+        };
+        vector<thread> pool;
+        for (int t = 1; t < min(threads, size - first); ++t) pool.emplace_back(worker);
+        worker();
+        for (auto& t : pool) t.join();
+    };
+
+    vector<Individual> population(size);
+    parallel_fill(population, 0, [&](mt19937& child_gen) {
+        vector<vector<RoutineEntry>> routine = initialize_routine(exercises, child_gen, profile);
+        repair_routine(routine, exercises, mav_targets, profile);
+        return routine;
+    });
+    sort(population.begin(), population.end(), by_cost);
+    Individual best = population[0];
+
+    optimizer_log() << "Starting genetic optimization..." << endl;
+    vector<Individual> next_population(size);
+    for (int generation = 0; generation < options.generations; ++generation) {
+        copy(population.begin(), population.begin() + elites, next_population.begin());
+        parallel_fill(next_population, elites, [&](mt19937& child_gen) {
+            const Individual& a = tournament_select(population, options.tournament, child_gen);
+            const Individual& b = tournament_select(population, options.tournament, child_gen);
+            uniform_real_distribution<> unit(0, 1);
+            vector<vector<RoutineEntry>> child;
+            if (unit(child_gen) >= options.crossover_rate) child = a.routine;
+            else if (unit(child_gen) < 0.5) child = day_crossover(a.routine, b.routine, child_gen);
+            else child = muscle_crossover(a.routine, b.routine, exercises, mav_targets, child_gen, profile, deficit_weights);
+            if (unit(child_gen) < options.mutation_rate) {
+                for (int moves = uniform_int_distribution<>(1, 3)(child_gen); moves > 0; --moves) {
+                    perturb_routine(child, exercises, mav_targets, uniform_int_distribution<>(0, NUM_MOVE_TYPES - 1)(child_gen), child_gen, profile);
+                }
+            }
+            repair_routine(child, exercises, mav_targets, profile);
+            return child;
+        });
+        population.swap(next_population);
+        sort(population.begin(), population.end(), by_cost);
+        bool improved = population[0].cost < best.cost;
+        if (improved) {
+            best = population[0];
+            optimizer_log() << "New best cost at generation " << generation << ": " << best.cost << endl;
+        }
+        if (generation % 100 == 0) {
+            optimizer_log() << "Generation " << generation << ": Best Cost = " << best.cost << ", Median Cost = " << population[size / 2].cost << endl;
+        }
+        report_progress(progress, generation + 1, 0.0, population[0].cost, best.cost, best.routine, improved);
+    }
+    best.cost = allocate_sets(best.routine, mav_targets, exercises, profile);
+    report_progress(progress, options.generations, 0.0, population[0].cost, best.cost, best.routine, false, true);
+    optimizer_log() << "Optimization complete. Final best cost: " << best.cost << endl;
+    return best.routine;
+}
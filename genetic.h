@@ -0,0 +1,31 @@
+#ifndef GENETIC_H
+#define GENETIC_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include "optimizer.h"
+
+// Struct to hold the genetic algorithm settings
+struct GeneticOptions {
+    unsigned int seed = 1;
+    int population = 64;
+    int generations = 250;
+    int tournament = 3;            // Individuals drawn per tournament
+    int elites = 2;                // Best individuals copied unchanged into the next generation
+    double crossover_rate = 0.9;   // Otherwise a child is a copy of its first parent
+    double mutation_rate = 0.4;    // Chance a child gets 1-3 perturb_routine moves
+    int threads = 0;               // 0 = one per hardware thread
+};
+
+// Struct to hold one member of the population
+struct Individual {
+    vector<vector<RoutineEntry>> routine;
+    double cost;
+};
+
+vector<vector<RoutineEntry>> day_crossover(const vector<vector<RoutineEntry>>& a, const vector<vector<RoutineEntry>>& b, mt19937& gen);
+vector<vector<RoutineEntry>> muscle_crossover(const vector<vector<RoutineEntry>>& a, const vector<vector<RoutineEntry>>& b, const vector<Exercise>& exercises, const unordered_map<string, MuscleGroup>& mav_targets, mt19937& gen, const OptimizerProfile* profile, const vector<double>& deficit_weights);
+vector<vector<RoutineEntry>> optimize_routine_genetic(const vector<Exercise>& exercises, const unordered_map<string, MuscleGroup>& mav_targets, const GeneticOptions& options = {}, const OptimizerProfile* profile = nullptr, ProgressObserver* progress = nullptr);
+
+#endif // GENETIC_H
@@ -0,0 +1,265 @@
+#include "neighbor_batch.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VOLUME_KERNEL_AVX2 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// Function to lay out the target muscles densely and precompute each exercise's volume per set
+VolumeKernel make_volume_kernel(const vector<Exercise>& exercises, const unordered_map<string, MuscleGroup>& mav_targets, const OptimizerProfile* profile) {
+    VolumeKernel kernel;
+    for (const auto& [muscle, target] : mav_targets) kernel.muscles.push_back(muscle);
+    sort(kernel.muscles.begin(), kernel.muscles.end());
+    kernel.stride = (kernel.muscles.size() + VOLUME_LANES - 1) / VOLUME_LANES * VOLUME_LANES;
+    kernel.targets.assign(kernel.stride, 0.0);
+    kernel.upper_bounds.assign(kernel.stride, 0.0);
+    kernel.deficit_weights.assign(kernel.stride, 0.0);
+    kernel.excess_weights.assign(kernel.stride, 0.0);
+    double excess_weight = weights_for(profile).excess_volume;
+    unordered_map<string, size_t> column;
+    for (size_t m = 0; m < kernel.muscles.size(); ++m) {
+        const string& muscle = kernel.muscles[m];
+        const MuscleGroup& target = mav_targets.at(muscle);
+        column[muscle] = m;
+        kernel.targets[m] = target.target;
+        kernel.upper_bounds[m] = target.upper_bound;
+        // Muscles volume_penalty skips (weight 0) get no excess term either
+        kernel.deficit_weights[m] = volume_deficit_weight(muscle, profile);
+        kernel.excess_weights[m] = kernel.deficit_weights[m] == 0.0 ? 0.0 : excess_weight;
+    }
+
+    kernel.contributions.assign(exercises.size() * kernel.stride, 0.0);
+    for (size_t e = 0; e < exercises.size(); ++e) {
+        kernel.exercise_index.emplace(exercises[e].name, static_cast<int>(e));
+        double* row = &kernel.contributions[e * kernel.stride];
+        auto add = [&](const vector<string>& muscles, double share) {
+            for (const auto& muscle : muscles) {
+                auto it = column.find(muscle);
+                if (it != column.end()) row[it->second] += share;
+            }
+        };
+        add(exercises[e].primary, 1.0);
+        add(exercises[e].secondary, 0.5);
+        add(exercises[e].isometric, 0.25);
+    }
+    return kernel;
+}
+
+// Function to add (sign 1) or remove (sign -1) one day's contribution to a dense volume row
+void add_dense_day_volumes(const VolumeKernel& kernel, const vector<RoutineEntry>& day_entries, double sign, double* volumes) {
+    for (const auto& entry : day_entries) {
+        auto it = kernel.exercise_index.find(entry.exercise);
+        if (it == kernel.exercise_index.end()) continue;
+        const double* row = &kernel.contributions[it->second * kernel.stride];
+        double sets = sign * entry.sets;
+        for (size_t m = 0; m < kernel.stride; ++m) volumes[m] += sets * row[m];
+    }
+}
+
+// Function to score the volume term (volume_penalty) of `count` dense volume rows. Each muscle adds
+// deficit_weight * max(target - v, 0)^2 + excess_weight * max(v - upper, 0)^2; at most one of the
+// two is non-zero. Lanes are summed in the same order as the AVX2 kernel, so both give identical
+// results.
+void batch_volume_penalties_scalar(const VolumeKernel& kernel, const double* volumes, size_t count, double* penalties) {
+    for (size_t k = 0; k < count; ++k) {
+        const double* v = volumes + k * kernel.stride;
+        double lanes[VOLUME_LANES] = {0.0, 0.0, 0.0, 0.0};
+        for (size_t m = 0; m < kernel.stride; m += VOLUME_LANES) {
+            for (size_t lane = 0; lane < VOLUME_LANES; ++lane) {
+                double deficit = max(kernel.targets[m + lane] - v[m + lane], 0.0);
+                double excess = max(v[m + lane] - kernel.upper_bounds[m + lane], 0.0);
+                lanes[lane] += kernel.deficit_weights[m + lane] * (deficit * deficit);
+                lanes[lane] += kernel.excess_weights[m + lane] * (excess * excess);
+            }
+        }
+        penalties[k] = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+}
+
+#ifdef VOLUME_KERNEL_AVX2
+// Function to score four muscles per instruction; built for AVX2 whatever the compiler flags,
+// and only called once the CPU is known to support it
+__attribute__((target("avx2")))
+static void avx2_volume_penalties(const VolumeKernel& kernel, const double* volumes, size_t count, double* penalties) {
+    const __m256d zero = _mm256_setzero_pd();
+    for (size_t k = 0; k < count; ++k) {
+        const double* v = volumes + k * kernel.stride;
+        __m256d sum = _mm256_setzero_pd();
+        for (size_t m = 0; m < kernel.stride; m += VOLUME_LANES) {
+            __m256d vol = _mm256_loadu_pd(v + m);
+            __m256d deficit = _mm256_max_pd(_mm256_sub_pd(_mm256_loadu_pd(&kernel.targets[m]), vol), zero);
+            __m256d excess = _mm256_max_pd(_mm256_sub_pd(vol, _mm256_loadu_pd(&kernel.upper_bounds[m])), zero);
+            sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_loadu_pd(&kernel.deficit_weights[m]), _mm256_mul_pd(deficit, deficit)));
+            sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_loadu_pd(&kernel.excess_weights[m]), _mm256_mul_pd(excess, excess)));
+        }
+        double lanes[VOLUME_LANES];
+        _mm256_storeu_pd(lanes, sum);
+        penalties[k] = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+}
+#endif
+
+// Function to check once whether the CPU running this process supports AVX2
+bool volume_kernel_has_avx2() {
+#ifdef VOLUME_KERNEL_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+// Function to score with the AVX2 kernel; returns false, leaving penalties untouched, when the
+// CPU does not support it
+bool batch_volume_penalties_avx2(const VolumeKernel& kernel, const double* volumes, size_t count, double* penalties) {
+#ifdef VOLUME_KERNEL_AVX2
+    if (volume_kernel_has_avx2()) {
+        avx2_volume_penalties(kernel, volumes, count, penalties);
+        return true;
+    }
+#endif
+    return false;
+}
+
+// Function to score `count` dense volume rows with the fastest kernel the CPU supports
+void batch_volume_penalties(const VolumeKernel& kernel, const double* volumes, size_t count, double* penalties) {
+    if (!batch_volume_penalties_avx2(kernel, volumes, count, penalties)) {
+        batch_volume_penalties_scalar(kernel, volumes, count, penalties);
+    }
+}
+
+// Struct to hold one proposal of a batched step
+struct BatchProposal {
+    int action;
+    int unrepaired;
+    vector<vector<RoutineEntry>> routine;
+    uint64_t hash;
+};
+
+// Function to check whether a day is unchanged by a proposal
+static bool same_day(const vector<RoutineEntry>& a, const vector<RoutineEntry>& b) {
+    return a.size() == b.size() && equal(a.begin(), a.end(), b.begin(), [](const RoutineEntry& x, const RoutineEntry& y) {
+        return x.exercise == y.exercise && x.sets == y.sets;
+    });
+}
+
+// Function to anneal with K proposals per step. The proposals' volume terms are scored together by
+// the kernel; they are then fully costed in order of that lower bound, stopping once the bound
+// can no longer beat the best costed proposal or (Metropolis) the acceptance threshold, which one
+// uniform draw fixes for the whole step. The temperature falls by COOLING_RATE^K per step, so a
+// run spends the same SA_ITERATIONS proposals on the same schedule as optimize_routine.
+vector<vector<RoutineEntry>> optimize_routine_batched(const vector<Exercise>& exercises,
+                                                      const unordered_map<string, MuscleGroup>& mav_targets,
+                                                      OptimizerTelemetry& telemetry,
+                                                      unsigned int seed,
+                                                      const BatchOptions& options,
+                                                      const OptimizerProfile* profile,
+                                                      ProgressObserver* progress) {
+    AnnealingState state = start_annealing(exercises, mav_targets, seed, profile);
+    VolumeKernel kernel = make_volume_kernel(exercises, mav_targets, profile);
+    int k = max(1, options.k);
+    double step_cooling = pow(COOLING_RATE, k);
+    vector<double> current(kernel.stride, 0.0);
+    for (const auto& day : state.routine) add_dense_day_volumes(kernel, day, 1.0, current.data());
+    vector<double> volumes(k * kernel.stride);
+    vector<double> bounds(k);
+    vector<BatchProposal> proposals;
+    vector<size_t> order;
+
+    optimizer_log() << "Starting batched optimization (K = " << k << ")..." << endl;
+    while (state.iteration < SA_ITERATIONS) {
+        auto perturb_start = TelemetryClock::now();
+        proposals.clear();
+        for (int i = 0; i < k; ++i) {
+            BatchProposal proposal{select_operator(state.selector, state.gen), 0, state.routine, 0};
+            if (!perturb_routine(proposal.routine, exercises, mav_targets, proposal.action, state.gen, profile)) {
+                update_operator(state.selector, proposal.action, 0.0);
+                record_no_op(telemetry, proposal.action);
+                continue;
+            }
+            proposal.unrepaired = repair_routine(proposal.routine, exercises, mav_targets, profile);
+            proposal.hash = proposal_hash(state.routine, proposal.routine, state.hash);
+            double* row = &volumes[proposals.size() * kernel.stride];
+            copy(current.begin(), current.end(), row);
+            for (int day = 0; day < TOTAL_DAYS; ++day) {
+                if (same_day(state.routine[day], proposal.routine[day])) continue;
+                add_dense_day_volumes(kernel, state.routine[day], -1.0, row);
+                add_dense_day_volumes(kernel, proposal.routine[day], 1.0, row);
+            }
+            proposals.push_back(move(proposal));
+        }
+        auto cost_start = TelemetryClock::now();
+        telemetry.perturb_seconds += seconds_between(perturb_start, cost_start);
+
+        batch_volume_penalties(kernel, volumes.data(), proposals.size(), bounds.data());
+        order.resize(proposals.size());
+        iota(order.begin(), order.end(), 0);
+        stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return bounds[a] < bounds[b]; });
+
+        // Any cost below the limit passes the Metropolis test for this step's draw
+        double draw = uniform_real_distribution<>(0, 1)(state.gen);
+        double limit = options.selection == BatchSelection::BestOfK ? numeric_limits<double>::max()
+                                                                    : state.current_cost - state.temperature * log(draw);
+        double chosen_cost = numeric_limits<double>::max();
+        int chosen = -1;
+        vector<double> costs(proposals.size(), numeric_limits<double>::max());
+        for (size_t i : order) {
+            const BatchProposal& proposal = proposals[i];
+            if (bounds[i] >= min(chosen_cost, limit)) {
+                // Only a proposal that certainly cannot improve earns the operator nothing
+                if (bounds[i] >= state.current_cost) update_operator(state.selector, proposal.action, 0.0);
+                record_screened(telemetry, proposal.action);
+                continue;
+            }
+            costs[i] = cached_cost(*state.costs, proposal.hash, proposal.routine, mav_targets, exercises, profile, state.deficit_weights, &telemetry.cost_table_hits);
+            update_operator(state.selector, proposal.action, improvement_reward(state.current_cost, costs[i]));
+            if (costs[i] < chosen_cost) {
+                chosen_cost = costs[i];
+                chosen = static_cast<int>(i);
+            }
+        }
+        auto accept_start = TelemetryClock::now();
+        telemetry.cost_seconds += seconds_between(cost_start, accept_start);
+
+        bool accept = chosen >= 0 && chosen_cost < limit;
+        bool improved = false;
+        for (size_t i = 0; i < proposals.size(); ++i) {
+            if (costs[i] == numeric_limits<double>::max()) continue;
+            record_move(telemetry, proposals[i].action, accept && static_cast<int>(i) == chosen,
+                        costs[i] < state.current_cost, proposals[i].unrepaired > 0);
+        }
+        if (accept) {
+            BatchProposal& proposal = proposals[chosen];
+            state.volumes = proposal_volumes(state.routine, proposal.routine, state.volumes, exercises);
+            copy(volumes.begin() + chosen * kernel.stride, volumes.begin() + (chosen + 1) * kernel.stride, current.begin());
+            state.hash = proposal.hash;
+            state.routine = move(proposal.routine);
+            state.current_cost = chosen_cost;
+            if (chosen_cost < state.best_cost) {
+                state.best_cost = chosen_cost;
+                state.best_routine = state.routine;
+                improved = true;
+                optimizer_log() << "New best cost at iteration " << state.iteration << ": " << state.best_cost << endl;
+            }
+        }
+        telemetry.accept_seconds += seconds_between(accept_start, TelemetryClock::now());
+        record_sample(telemetry, state.iteration, state.temperature, state.current_cost, state.best_cost);
+
+        if (state.iteration / 1000 != (state.iteration + k) / 1000) {
+            optimizer_log() << "Iteration " << state.iteration << ": Temp = " << state.temperature << ", Best Cost = " << state.best_cost << endl;
+        }
+        state.temperature *= step_cooling;
+        state.iteration += k;
+        report_progress(progress, state.iteration, state.temperature, state.current_cost, state.best_cost, state.best_routine, improved);
+    }
+    state.best_cost = allocate_sets(state.best_routine, mav_targets, exercises, profile);
+    report_progress(progress, state.iteration, state.temperature, state.current_cost, state.best_cost, state.best_routine, false, true);
+    optimizer_log() << "Optimization complete. Final best cost: " << state.best_cost << endl;
+    return state.best_routine;
+}
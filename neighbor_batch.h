@@ -0,0 +1,45 @@
+#ifndef NEIGHBOR_BATCH_H
+#define NEIGHBOR_BATCH_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "optimizer.h"
+
+// Muscles per SIMD register (four doubles in an AVX2 register)
+const size_t VOLUME_LANES = 4;
+
+// Dense muscle layout for scoring the volume term of many proposals at once. Each routine's
+// volumes are one row of `stride` doubles; padding lanes have no weight.
+struct VolumeKernel {
+    std::vector<std::string> muscles;             // Target muscles, sorted
+    size_t stride;                                // muscles.size() rounded up to VOLUME_LANES
+    std::unordered_map<std::string, int> exercise_index;
+    std::vector<double> contributions;            // Volume per set, one row per exercise
+    std::vector<double> targets;
+    std::vector<double> upper_bounds;
+    std::vector<double> deficit_weights;
+    std::vector<double> excess_weights;
+};
+
+// How a batched step picks among its K scored proposals
+enum class BatchSelection {
+    Metropolis,  // The best proposal, accepted by the Metropolis test
+    BestOfK      // The best proposal, always taken
+};
+
+// Struct to hold the batched search settings
+struct BatchOptions {
+    int k = 8;
+    BatchSelection selection = BatchSelection::Metropolis;
+};
+
+VolumeKernel make_volume_kernel(const std::vector<Exercise>& exercises, const std::unordered_map<std::string, MuscleGroup>& mav_targets, const OptimizerProfile* profile = nullptr);
+void add_dense_day_volumes(const VolumeKernel& kernel, const std::vector<RoutineEntry>& day_entries, double sign, double* volumes);
+bool volume_kernel_has_avx2();
+void batch_volume_penalties_scalar(const VolumeKernel& kernel, const double* volumes, size_t count, double* penalties);
+bool batch_volume_penalties_avx2(const VolumeKernel& kernel, const double* volumes, size_t count, double* penalties);
+void batch_volume_penalties(const VolumeKernel& kernel, const double* volumes, size_t count, double* penalties);
+std::vector<std::vector<RoutineEntry>> optimize_routine_batched(const std::vector<Exercise>& exercises, const std::unordered_map<std::string, MuscleGroup>& mav_targets, OptimizerTelemetry& telemetry, unsigned int seed, const BatchOptions& options, const OptimizerProfile* profile = nullptr, ProgressObserver* progress = nullptr);
+
+#endif // NEIGHBOR_BATCH_H
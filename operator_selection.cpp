@@ -0,0 +1,50 @@
+#include "operator_selection.h"
+#include <algorithm>
+
+using namespace std;
+
+// Quality below which an operator counts as having earned nothing (exponential decay never reaches zero)
+static const double MIN_QUALITY = 1e-6;
+
+// Function to create a selector with uniform probabilities and neutral quality estimates
+OperatorSelector make_operator_selector(int num_operators, double alpha, double beta, double p_min) {
+    OperatorSelector selector;
+    selector.alpha = alpha;
+    selector.beta = beta;
+    selector.p_min = min(p_min, 1.0 / num_operators);
+    selector.quality.assign(num_operators, 0.0);
+    selector.probability.assign(num_operators, 1.0 / num_operators);
+    return selector;
+}
+
+// Function to draw an operator by roulette wheel over the current probabilities
+int select_operator(const OperatorSelector& selector, mt19937& gen) {
+    double r = uniform_real_distribution<>(0, 1)(gen);
+    double cumulative = 0.0;
+    for (size_t op = 0; op < selector.probability.size(); ++op) {
+        cumulative += selector.probability[op];
+        if (r < cumulative) return static_cast<int>(op);
+    }
+    return static_cast<int>(selector.probability.size()) - 1;
+}
+
+// Function to credit an operator with its reward and pursue the current best operator.
+// While no operator has earned anything the probabilities drift back to uniform.
+void update_operator(OperatorSelector& selector, int op, double reward) {
+    selector.quality[op] += selector.alpha * (reward - selector.quality[op]);
+    size_t best = max_element(selector.quality.begin(), selector.quality.end()) - selector.quality.begin();
+    bool any_reward = selector.quality[best] > MIN_QUALITY;
+    double uniform = 1.0 / selector.probability.size();
+    double p_max = 1.0 - (selector.quality.size() - 1) * selector.p_min;
+    for (size_t i = 0; i < selector.probability.size(); ++i) {
+        double goal = !any_reward ? uniform : (i == best) ? p_max : selector.p_min;
+        selector.probability[i] += selector.beta * (goal - selector.probability[i]);
+    }
+}
+
+// Function to turn a cost change into a reward in [0, 1]: the relative improvement
+double improvement_reward(double current_cost, double new_cost) {
+    if (new_cost >= current_cost) return 0.0;
+    if (current_cost <= 0.0) return 0.0;
+    return (current_cost - new_cost) / current_cost;
+}
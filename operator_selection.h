@@ -0,0 +1,21 @@
+#ifndef OPERATOR_SELECTION_H
+#define OPERATOR_SELECTION_H
+
+#include <vector>
+#include <random>
+
+// Adaptive pursuit bandit over perturbation operators
+struct OperatorSelector {
+    double alpha;                      // Learning rate for operator quality estimates
+    double beta;                       // Pursuit rate for selection probabilities
+    double p_min;                      // Floor probability so no operator is starved
+    std::vector<double> quality;
+    std::vector<double> probability;
+};
+
+OperatorSelector make_operator_selector(int num_operators, double alpha = 0.1, double beta = 0.1, double p_min = 0.05);
+int select_operator(const OperatorSelector& selector, std::mt19937& gen);
+void update_operator(OperatorSelector& selector, int op, double reward);
+double improvement_reward(double current_cost, double new_cost);
+
+#endif // OPERATOR_SELECTION_H
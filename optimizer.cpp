@@ -0,0 +1,978 @@
+#include "optimizer.h"
+#include "operator_selection.h"
+#include "checkpoint.h"
+#include "set_allocation.h"
+#include <iostream>
+#include <algorithm>
+#include <set>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <numeric>
+#include <cmath>
+#include <limits>
+#include <chrono>
+
+// Muscle recovery days
+unordered_map<string, int> muscle_recovery_days = {
+    {"Quads", 2}, {"Hamstrings", 2}, {"Glutes", 1}, {"Chest", 1},
+    {"Back", 1}, {"Shoulders", 1}, {"Triceps", 1}, {"Biceps", 1},
+    {"Short Head", 1}, {"Long Head", 1}, {"Lower Traps", 1},
+    {"Lateral Delts", 1}, {"Lower Back", 1}
+};
+
+// Exercise definitions
+vector<Exercise> exercises = {
+    {"Bench Press", {"Chest"}, {"Triceps", "Shoulders"}, {}, true, false},
+    {"Squat", {"Quads", "Glutes"}, {"Hamstrings", "Lower Back"}, {}, true, true},
+    {"Deadlift", {"Back", "Glutes"}, {"Hamstrings", "Lower Back"}, {}, true, false},
+    {"Overhead Press", {"Shoulders"}, {"Triceps"}, {}, true, false},
+    {"Pull-Up", {"Back", "Biceps"}, {}, {}, true, false},
+    {"Leg Curl", {"Hamstrings"}, {"Short Head"}, {}, false, true},
+    {"Leg Extension", {"Quads"}, {}, {}, false, true},
+    {"Bicep Curl", {"Biceps"}, {}, {}, false, false},
+    {"Tricep Extension", {"Triceps"}, {}, {}, false, false},
+    {"Lateral Raise", {"Lateral Delts"}, {"Shoulders"}, {}, false, false},
+    {"Kelso Shrugs", {"Lower Traps"}, {"Back"}, {}, false, false},
+    {"Stiff-Legged Deadlift", {"Hamstrings", "Lower Back"}, {"Glutes"}, {}, false, true}
+};
+
+// Muscle volume targets (MAV: Minimum Adaptive Volume)
+unordered_map<string, MuscleGroup> mav_targets = {
+    {"Quads", {12.0, 20.0}}, {"Hamstrings", {12.0, 20.0}}, {"Glutes", {8.0, 16.0}},
+    {"Chest", {10.0, 18.0}}, {"Back", {12.0, 20.0}}, {"Shoulders", {10.0, 18.0}},
+    {"Triceps", {8.0, 16.0}}, {"Biceps", {8.0, 16.0}}, {"Short Head", {8.0, 16.0}},
+    {"Long Head", {8.0, 16.0}}, {"Lower Traps", {8.0, 16.0}}, {"Lateral Delts", {8.0, 16.0}},
+    {"Lower Back", {8.0, 16.0}}
+};
+
+// Stream the engines log progress to on each thread; null silences them
+static thread_local ostream* optimizer_log_stream = &cout;
+
+// Function to get the calling thread's engine log: cout unless set_optimizer_log redirected it
+ostream& optimizer_log() {
+    static thread_local ostream silent(nullptr);
+    return optimizer_log_stream ? *optimizer_log_stream : silent;
+}
+
+// Function to redirect the calling thread's engine log (null silences it); returns the previous
+// stream so the caller can restore it
+ostream* set_optimizer_log(ostream* log) {
+    ostream* previous = optimizer_log_stream;
+    optimizer_log_stream = log;
+    return previous;
+}
+
+// Check if a muscle is recently used based on recovery days
+bool is_muscle_recently_used(const vector<vector<RoutineEntry>>& routine, int current_day, const string& muscle, const vector<Exercise>& exercises, const OptimizerProfile* profile) {
+    int recovery_days = recovery_days_for(muscle, profile);
+    for (int day = max(0, current_day - recovery_days); day < current_day; ++day) {
+        for (const auto& entry : routine[day]) {
+            auto ex = find_if(exercises.begin(), exercises.end(), [&](const Exercise& e) { return e.name == entry.exercise; });
+            if (ex != exercises.end() && (find(ex->primary.begin(), ex->primary.end(), muscle) != ex->primary.end() ||
+                                          find(ex->secondary.begin(), ex->secondary.end(), muscle) != ex->secondary.end())) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Add (sign 1) or remove (sign -1) one day's contribution to the muscle volumes
+void add_day_volumes(map<string, double>& volumes, const vector<RoutineEntry>& day_entries, const vector<Exercise>& exercises, double sign) {
+    for (const auto& entry : day_entries) {
+        auto it = find_if(exercises.begin(), exercises.end(), [&](const Exercise& e) { return e.name == entry.exercise; });
+        if (it == exercises.end()) continue;
+        const Exercise& ex = *it;
+        for (const auto& muscle : ex.primary) {
+            volumes[muscle] += sign * entry.sets * 1.0;
+        }
+        for (const auto& muscle : ex.secondary) {
+            volumes[muscle] += sign * entry.sets * 0.5;
+        }
+        for (const auto& muscle : ex.isometric) {
+            volumes[muscle] += sign * entry.sets * 0.25;
+        }
+    }
+}
+
+// Compute muscle volumes across the routine
+map<string, double> compute_volumes(const vector<vector<RoutineEntry>>& routine, const vector<Exercise>& exercises) {
+    map<string, double> volumes;
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        add_day_volumes(volumes, routine[day], exercises, 1.0);
+    }
+    return volumes;
+}
+
+// Function to check whether a proposal leaves a day's entries unchanged
+static bool same_entries(const vector<RoutineEntry>& a, const vector<RoutineEntry>& b) {
+    return a.size() == b.size() && equal(a.begin(), a.end(), b.begin(), [](const RoutineEntry& x, const RoutineEntry& y) {
+        return x.exercise == y.exercise && x.sets == y.sets;
+    });
+}
+
+// Update the current volumes for a proposal by re-adding only the days that differ
+map<string, double> proposal_volumes(const vector<vector<RoutineEntry>>& routine,
+                                     const vector<vector<RoutineEntry>>& proposal,
+                                     const map<string, double>& volumes,
+                                     const vector<Exercise>& exercises) {
+    map<string, double> result = volumes;
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        if (same_entries(routine[day], proposal[day])) continue;
+        add_day_volumes(result, routine[day], exercises, -1.0);
+        add_day_volumes(result, proposal[day], exercises, 1.0);
+    }
+    return result;
+}
+
+// Recovery days for a muscle, from the profile when it overrides the muscle; 0 for unknown muscles
+int recovery_days_for(const string& muscle, const OptimizerProfile* profile) {
+    if (profile) {
+        auto it = profile->recovery_days.find(muscle);
+        if (it != profile->recovery_days.end()) return it->second;
+    }
+    auto it = muscle_recovery_days.find(muscle);
+    return it != muscle_recovery_days.end() ? it->second : 0;
+}
+
+// Function to pick the penalty weights for a member: the profile's own, else the active set
+const CostWeights& weights_for(const OptimizerProfile* profile) {
+    return profile && profile->weights ? *profile->weights : cost_weights;
+}
+
+// Weight of a squared volume deficit in compute_cost; 0 for muscles that are not optimized
+double volume_deficit_weight(const string& muscle, const OptimizerProfile* profile) {
+    const CostWeights& weights = weights_for(profile);
+    auto it = weights.deficit_weights.find(muscle);
+    return it != weights.deficit_weights.end() ? it->second : weights.default_deficit;
+}
+
+// Function to resolve volume_deficit_weight for every muscle once, in mav_targets iteration order,
+// so the cost loops index a vector instead of searching the weight maps per muscle
+vector<double> resolve_deficit_weights(const unordered_map<string, MuscleGroup>& mav_targets, const OptimizerProfile* profile) {
+    vector<double> weights;
+    weights.reserve(mav_targets.size());
+    for (const auto& [muscle, target] : mav_targets) weights.push_back(volume_deficit_weight(muscle, profile));
+    return weights;
+}
+
+// Volume term of compute_cost, with deficit_weights from resolve_deficit_weights on the same
+// mav_targets; every other term is non-negative, so this is a lower bound on the cost
+double volume_penalty(const map<string, double>& volumes, const unordered_map<string, MuscleGroup>& mav_targets,
+                      const vector<double>& deficit_weights, double excess_weight) {
+    double penalty = 0.0;
+    size_t m = 0;
+    for (const auto& [muscle, target] : mav_targets) {
+        double weight = deficit_weights[m++];
+        if (weight == 0.0) continue;
+        auto it = volumes.find(muscle);
+        double vol = it != volumes.end() ? it->second : 0.0;
+        double deficit = target.target - vol;
+        if (deficit > 0) {
+            penalty += weight * pow(deficit, 2);
+        } else if (vol > target.upper_bound) {
+            penalty += excess_weight * pow(vol - target.upper_bound, 2);
+        }
+    }
+    return penalty;
+}
+
+// Cost function with penalties
+double compute_cost(const vector<vector<RoutineEntry>>& routine, 
+                    const unordered_map<string, MuscleGroup>& mav_targets, 
+                    const vector<Exercise>& exercises,
+                    const OptimizerProfile* profile) {
+    return compute_cost(routine, mav_targets, exercises, profile, resolve_deficit_weights(mav_targets, profile));
+}
+
+// Cost function with the deficit weights already resolved (see resolve_deficit_weights)
+double compute_cost(const vector<vector<RoutineEntry>>& routine,
+                    const unordered_map<string, MuscleGroup>& mav_targets,
+                    const vector<Exercise>& exercises,
+                    const OptimizerProfile* profile,
+                    const vector<double>& deficit_weights) {
+    const CostWeights& weights = weights_for(profile);
+    auto volumes = compute_volumes(routine, exercises);
+    map<string, int> exercise_frequency;
+    double total_time_penalty = 0.0;
+    double frequency_penalty = 0.0;
+    double time_variance_penalty = 0.0;
+    double compound_first_penalty = 0.0;
+    double inclusion_penalty = 0.0;
+    double structure_penalty = 0.0;
+
+    vector<double> day_times(TOTAL_DAYS, 0.0);
+    set<string> included_exercises;
+
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        set<string> day_exercises;
+        int leg_exercises = 0;
+        double day_time = 0.0;
+        bool compound_first = false;
+        for (size_t i = 0; i < routine[day].size(); ++i) {
+            const auto& entry = routine[day][i];
+            if (day_exercises.count(entry.exercise)) {
+                structure_penalty += weights.structure; // No repeats within a day
+                continue;
+            }
+            day_exercises.insert(entry.exercise);
+            included_exercises.insert(entry.exercise);
+            exercise_frequency[entry.exercise]++;
+            auto ex = find_if(exercises.begin(), exercises.end(), 
+                            [&](const Exercise& e) { return e.name == entry.exercise; });
+            if (ex != exercises.end()) {
+                if (i == 0 && ex->is_compound) compound_first = true;
+                if (ex->is_leg) leg_exercises++;
+                day_time += entry.sets * TIME_PER_SET;
+            }
+        }
+        if (!compound_first && !routine[day].empty()) {
+            compound_first_penalty += weights.compound_first;
+        }
+        int size = routine[day].size();
+        if (size < MIN_EXERCISES_PER_DAY) {
+            structure_penalty += weights.structure * (MIN_EXERCISES_PER_DAY - size);
+        } else if (size > MAX_EXERCISES_PER_DAY) {
+            structure_penalty += weights.structure * (size - MAX_EXERCISES_PER_DAY);
+        }
+        if (leg_exercises > 2) {
+            structure_penalty += weights.structure * (leg_exercises - 2);
+        }
+        if (day_time > MAX_TIME_PER_DAY) {
+            total_time_penalty += weights.overtime * (day_time - MAX_TIME_PER_DAY);
+        }
+        day_times[day] = day_time;
+    }
+
+    if (included_exercises.find("Leg Curl") == included_exercises.end()) {
+        inclusion_penalty += weights.inclusion; // Ensure Short Head coverage
+    }
+
+    double avg_time = accumulate(day_times.begin(), day_times.end(), 0.0) / TOTAL_DAYS;
+    for (double time : day_times) {
+        double diff = time - avg_time;
+        time_variance_penalty += (diff > 0 ? weights.time_variance_over : weights.time_variance_under) * pow(diff, 2);
+    }
+
+    double volume_term = volume_penalty(volumes, mav_targets, deficit_weights, weights.excess_volume);
+
+    for (const auto& [ex, freq] : exercise_frequency) {
+        if (freq > 2) {
+            frequency_penalty += weights.frequency * (freq - 2);
+        }
+    }
+
+    return volume_term + frequency_penalty + total_time_penalty + time_variance_penalty + compound_first_penalty + inclusion_penalty + structure_penalty;
+}
+
+// Function to compute the Zobrist hash of one day (see zobrist_key)
+static uint64_t day_hash(const vector<RoutineEntry>& entries, int day) {
+    uint64_t hash = 0;
+    for (size_t i = 0; i < entries.size(); ++i) hash ^= zobrist_key(day, i, entries[i].exercise, entries[i].sets);
+    return hash;
+}
+
+// Function to compute the Zobrist hash of a routine from scratch
+uint64_t routine_hash(const vector<vector<RoutineEntry>>& routine) {
+    uint64_t hash = 0;
+    for (size_t day = 0; day < routine.size(); ++day) hash ^= day_hash(routine[day], day);
+    return hash;
+}
+
+// Function to derive a proposal's hash from its parent's, rehashing only the days it changed
+uint64_t proposal_hash(const vector<vector<RoutineEntry>>& routine, const vector<vector<RoutineEntry>>& proposal, uint64_t hash) {
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        if (same_entries(routine[day], proposal[day])) continue;
+        hash ^= day_hash(routine[day], day) ^ day_hash(proposal[day], day);
+    }
+    return hash;
+}
+
+// Function to cost a routine through a transposition table: a routine already in the table costs
+// one lookup, and anything else is costed and stored. Counts hits in *hits when given.
+double cached_cost(CostTable& table, uint64_t hash,
+                   const vector<vector<RoutineEntry>>& routine,
+                   const unordered_map<string, MuscleGroup>& mav_targets,
+                   const vector<Exercise>& exercises,
+                   const OptimizerProfile* profile,
+                   const vector<double>& deficit_weights,
+                   long* hits) {
+    double cost;
+    if (probe_cost(table, hash, cost)) {
+        if (hits) ++*hits;
+        return cost;
+    }
+    cost = compute_cost(routine, mav_targets, exercises, profile, deficit_weights);
+    store_cost(table, hash, cost);
+    return cost;
+}
+
+// Function to finish a routine by choosing every entry's sets for its fixed exercises (see
+// solve_set_allocation: exact per day, coordinate descent across days). Only the volume and time terms of compute_cost depend on sets;
+// days are held to MAX_TIME_PER_DAY as check_routine requires, and the result is kept only if
+// compute_cost agrees it is no worse. With a deadline, solving stops before the first day that
+// would start after it. Returns the routine's cost.
+double allocate_sets(vector<vector<RoutineEntry>>& routine,
+                     const unordered_map<string, MuscleGroup>& mav_targets,
+                     const vector<Exercise>& exercises,
+                     const OptimizerProfile* profile,
+                     const TelemetryClock::time_point* deadline) {
+    const CostWeights& weights = weights_for(profile);
+    SetAllocationProblem problem;
+    vector<string> muscles;
+    for (const auto& [muscle, target] : mav_targets) muscles.push_back(muscle);
+    sort(muscles.begin(), muscles.end());
+    problem.muscles = muscles.size();
+    for (const auto& muscle : muscles) {
+        double weight = volume_deficit_weight(muscle, profile);
+        problem.targets.push_back(mav_targets.at(muscle).target);
+        problem.upper_bounds.push_back(mav_targets.at(muscle).upper_bound);
+        problem.deficit_weights.push_back(weight);
+        problem.excess_weights.push_back(weight == 0.0 ? 0.0 : weights.excess_volume);
+    }
+    problem.min_sets = MIN_SETS;
+    problem.max_sets = MAX_SETS;
+    problem.max_day_time = MAX_TIME_PER_DAY;
+    problem.overtime_weight = weights.overtime;
+    problem.time_variance_over = weights.time_variance_over;
+    problem.time_variance_under = weights.time_variance_under;
+    problem.day_items.resize(TOTAL_DAYS);
+    problem.day_fixed_times.assign(TOTAL_DAYS, 0.0);
+
+    vector<pair<int, size_t>> positions;   // (day, entry) of each item
+    vector<int> sets;
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        for (size_t i = 0; i < routine[day].size(); ++i) {
+            map<string, double> per_set;
+            add_day_volumes(per_set, {{routine[day][i].exercise, 1}}, exercises, 1.0);
+            if (per_set.empty()) continue;  // Not in the catalog: no volume or time in compute_cost
+            problem.day_items[day].push_back(positions.size());
+            for (const auto& muscle : muscles) {
+                auto it = per_set.find(muscle);
+                problem.item_volumes.push_back(it != per_set.end() ? it->second : 0.0);
+            }
+            problem.item_times.push_back(TIME_PER_SET);
+            positions.push_back({day, i});
+            sets.push_back(routine[day][i].sets);
+        }
+    }
+
+    double cost = compute_cost(routine, mav_targets, exercises, profile);
+    function<bool()> out_of_time;
+    if (deadline) out_of_time = [deadline]() { return TelemetryClock::now() >= *deadline; };
+    solve_set_allocation(problem, sets, out_of_time);
+    vector<vector<RoutineEntry>> allocated = routine;
+    for (size_t item = 0; item < positions.size(); ++item) allocated[positions[item].first][positions[item].second].sets = sets[item];
+    double allocated_cost = compute_cost(allocated, mav_targets, exercises, profile);
+    if (allocated_cost > cost) return cost;
+    routine.swap(allocated);
+    return allocated_cost;
+}
+
+// Collect exercises that can be added to a day: not already in it, within the leg limit,
+// isolation only, primary muscles recovered and hitting at least one under-target muscle
+vector<Exercise> candidate_exercises(const vector<vector<RoutineEntry>>& routine, int day,
+                                     const vector<Exercise>& exercises,
+                                     const vector<string>& under_target_muscles,
+                                     const OptimizerProfile* profile) {
+    set<string> current_exercises;
+    int leg_count = 0;
+    for (const auto& entry : routine[day]) {
+        current_exercises.insert(entry.exercise);
+        auto ex = find_if(exercises.begin(), exercises.end(), [&](const Exercise& e) { return e.name == entry.exercise; });
+        if (ex != exercises.end() && ex->is_leg) leg_count++;
+    }
+    vector<Exercise> candidates;
+    for (const auto& ex : exercises) {
+        bool is_leg = ex.is_leg;
+        if (!current_exercises.count(ex.name) && (!is_leg || leg_count < 2) && !ex.is_compound) {
+            bool valid = true;
+            for (const auto& muscle : ex.primary) {
+                if (is_muscle_recently_used(routine, day, muscle, exercises, profile)) {
+                    valid = false;
+                    break;
+                }
+            }
+            if (valid && any_of(ex.primary.begin(), ex.primary.end(), [&](const string& m) {
+                return find(under_target_muscles.begin(), under_target_muscles.end(), m) != under_target_muscles.end();
+            })) {
+                candidates.push_back(ex);
+            }
+        }
+    }
+    return candidates;
+}
+
+// Perturb the routine with the given action on one random day; returns false when the
+// move does not apply to that day (nothing changed, so there is nothing to evaluate)
+bool perturb_routine(vector<vector<RoutineEntry>>& routine, 
+                     const vector<Exercise>& exercises, 
+                     const unordered_map<string, MuscleGroup>& mav_targets,
+                     int action,
+                     mt19937& gen,
+                     const OptimizerProfile* profile) {
+    uniform_int_distribution<> day_dist(0, TOTAL_DAYS - 1);
+    int day = day_dist(gen);
+
+    vector<string> under_target_muscles;
+    if (action == 1 || action == 2 || action == 4) {
+        auto volumes = compute_volumes(routine, exercises);
+        for (const auto& [muscle, target] : mav_targets) {
+            double vol = volumes.count(muscle) ? volumes[muscle] : 0.0;
+            if (vol < target.target) under_target_muscles.push_back(muscle);
+        }
+    }
+
+    if (action == 0) { // Remove
+        if (routine[day].size() <= MIN_EXERCISES_PER_DAY) return false;
+        uniform_int_distribution<> ex_dist(1, routine[day].size() - 1);
+        routine[day].erase(routine[day].begin() + ex_dist(gen));
+        return true;
+    } else if (action == 1) { // Replace
+        if (routine[day].size() < 2) return false;
+        uniform_int_distribution<> idx_dist(1, routine[day].size() - 1);
+        int idx = idx_dist(gen);
+        vector<Exercise> candidates = candidate_exercises(routine, day, exercises, under_target_muscles, profile);
+        if (candidates.empty()) return false;
+        uniform_int_distribution<> new_ex_dist(0, candidates.size() - 1);
+        routine[day][idx].exercise = candidates[new_ex_dist(gen)].name;
+        uniform_int_distribution<> sets_dist(MIN_SETS + 1, MAX_SETS);
+        routine[day][idx].sets = sets_dist(gen);
+        return true;
+    } else if (action == 2) { // Add
+        if (routine[day].size() >= MAX_EXERCISES_PER_DAY) return false;
+        vector<Exercise> candidates = candidate_exercises(routine, day, exercises, under_target_muscles, profile);
+        if (candidates.empty()) return false;
+        uniform_int_distribution<> ex_dist(0, candidates.size() - 1);
+        string new_ex = candidates[ex_dist(gen)].name;
+        uniform_int_distribution<> sets_dist(MIN_SETS + 1, MAX_SETS);
+        routine[day].push_back({new_ex, sets_dist(gen)});
+        return true;
+    } else if (action == 3) { // Swap days
+        if (TOTAL_DAYS < 2) return false;
+        int day2 = day_dist(gen);
+        while (day2 == day) day2 = day_dist(gen);
+        swap(routine[day], routine[day2]);
+        return true;
+    } else if (action == 4) { // Adjust sets
+        bool changed = false;
+        for (auto& entry : routine[day]) {
+            if (entry.sets >= MAX_SETS) continue;
+            auto ex = find_if(exercises.begin(), exercises.end(), [&](const Exercise& e) { return e.name == entry.exercise; });
+            if (ex != exercises.end()) {
+                for (const auto& muscle : ex->primary) {
+                    if (find(under_target_muscles.begin(), under_target_muscles.end(), muscle) != under_target_muscles.end()) {
+                        uniform_int_distribution<> sets_adj(1, 2);
+                        entry.sets = min(entry.sets + sets_adj(gen), MAX_SETS);
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+        return changed;
+    } else if (action == 5) { // Swap within day
+        if (routine[day].size() <= 2) return false;
+        uniform_int_distribution<> idx_dist(1, routine[day].size() - 1);
+        int idx1 = idx_dist(gen);
+        int idx2 = idx_dist(gen);
+        while (idx2 == idx1) idx2 = idx_dist(gen);
+        swap(routine[day][idx1], routine[day][idx2]);
+        return true;
+    }
+    return false;
+}
+
+// Restore a day's structure with minimal edits: drop repeats, then extra leg exercises and
+// extra entries from the end (keeping the first slot), then append the exercise covering the
+// largest remaining volume deficit until the day has enough entries. Returns the violations
+// that could not be repaired (only when the catalog has too few usable exercises).
+int repair_day(vector<vector<RoutineEntry>>& routine, int day,
+               map<string, double>& volumes,
+               const vector<Exercise>& exercises,
+               const unordered_map<string, MuscleGroup>& mav_targets,
+               const OptimizerProfile* profile) {
+    vector<RoutineEntry>& entries = routine[day];
+    auto find_exercise = [&](const string& name) {
+        return find_if(exercises.begin(), exercises.end(), [&](const Exercise& e) { return e.name == name; });
+    };
+
+    set<string> seen;
+    for (size_t i = 0; i < entries.size();) {
+        if (seen.insert(entries[i].exercise).second) {
+            ++i;
+            continue;
+        }
+        add_day_volumes(volumes, {entries[i]}, exercises, -1.0);
+        entries.erase(entries.begin() + i);
+    }
+
+    int leg_count = count_if(entries.begin(), entries.end(), [&](const RoutineEntry& entry) {
+        auto ex = find_exercise(entry.exercise);
+        return ex != exercises.end() && ex->is_leg;
+    });
+    for (int i = entries.size() - 1; i >= 0 && leg_count > 2; --i) {
+        auto ex = find_exercise(entries[i].exercise);
+        if (ex == exercises.end() || !ex->is_leg || (i == 0 && entries.size() > 1)) continue;
+        add_day_volumes(volumes, {entries[i]}, exercises, -1.0);
+        entries.erase(entries.begin() + i);
+        leg_count--;
+    }
+
+    while (entries.size() > MAX_EXERCISES_PER_DAY) {
+        add_day_volumes(volumes, {entries.back()}, exercises, -1.0);
+        entries.pop_back();
+    }
+
+    while (entries.size() < MIN_EXERCISES_PER_DAY) {
+        const Exercise* best = nullptr;
+        double best_score = -1.0;
+        bool best_recovered = false;
+        for (const auto& ex : exercises) {
+            if (seen.count(ex.name) || (ex.is_leg && leg_count >= 2)) continue;
+            // An empty day needs a compound to lead it; later slots take isolations
+            if (ex.is_compound != entries.empty()) continue;
+            bool recovered = none_of(ex.primary.begin(), ex.primary.end(), [&](const string& muscle) {
+                return is_muscle_recently_used(routine, day, muscle, exercises, profile);
+            });
+            double score = 0.0;
+            for (const auto& muscle : ex.primary) {
+                auto target = mav_targets.find(muscle);
+                if (target == mav_targets.end()) continue;
+                auto vol = volumes.find(muscle);
+                score += max(0.0, target->second.target - (vol != volumes.end() ? vol->second : 0.0));
+            }
+            if (!best || (recovered && !best_recovered) || (recovered == best_recovered && score > best_score)) {
+                best = &ex;
+                best_score = score;
+                best_recovered = recovered;
+            }
+        }
+        if (!best) break;
+        entries.push_back({best->name, MIN_SETS + 1});
+        add_day_volumes(volumes, {entries.back()}, exercises, 1.0);
+        seen.insert(best->name);
+        if (best->is_leg) leg_count++;
+    }
+
+    int remaining = max(0, leg_count - 2);
+    if (entries.size() < MIN_EXERCISES_PER_DAY) remaining += MIN_EXERCISES_PER_DAY - entries.size();
+    return remaining;
+}
+
+// Repair every day of the routine; returns the number of violations left for compute_cost to grade
+int repair_routine(vector<vector<RoutineEntry>>& routine,
+                   const vector<Exercise>& exercises,
+                   const unordered_map<string, MuscleGroup>& mav_targets,
+                   const OptimizerProfile* profile) {
+    map<string, double> volumes;
+    bool have_volumes = false;
+    int remaining = 0;
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        // Most proposals leave the structure intact, so check cheaply before repairing
+        set<string> day_exercises;
+        int leg_count = 0;
+        bool broken = routine[day].size() < MIN_EXERCISES_PER_DAY || routine[day].size() > MAX_EXERCISES_PER_DAY;
+        for (const auto& entry : routine[day]) {
+            if (!day_exercises.insert(entry.exercise).second) broken = true;
+            auto ex = find_if(exercises.begin(), exercises.end(), [&](const Exercise& e) { return e.name == entry.exercise; });
+            if (ex != exercises.end() && ex->is_leg) leg_count++;
+        }
+        if (!broken && leg_count <= 2) continue;
+        if (!have_volumes) {
+            volumes = compute_volumes(routine, exercises);
+            have_volumes = true;
+        }
+        remaining += repair_day(routine, day, volumes, exercises, mav_targets, profile);
+    }
+    return remaining;
+}
+
+// Initialize routine
+vector<vector<RoutineEntry>> initialize_routine(const vector<Exercise>& exercises, mt19937& gen, const OptimizerProfile* profile) {
+    vector<vector<RoutineEntry>> routine(TOTAL_DAYS);
+    vector<Exercise> compounds;
+    vector<Exercise> isolations;
+
+    for (const auto& ex : exercises) {
+        if (ex.is_compound) compounds.push_back(ex);
+        else isolations.push_back(ex);
+    }
+
+    uniform_int_distribution<> isolation_dist(3, 5);
+    set<string> critical_exercises = {"Leg Curl", "Kelso Shrugs", "Lateral Raise"};
+
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        set<string> used_exercises;
+        int leg_count = 0;
+
+        shuffle(compounds.begin(), compounds.end(), gen);
+        for (const auto& ex : compounds) {
+            if (used_exercises.insert(ex.name).second && (!ex.is_leg || leg_count < 2)) {
+                bool valid = true;
+                for (const auto& muscle : ex.primary) {
+                    if (is_muscle_recently_used(routine, day, muscle, exercises, profile)) {
+                        valid = false;
+                        break;
+                    }
+                }
+                if (valid) {
+                    uniform_int_distribution<> sets_dist(MIN_SETS + 1, MAX_SETS);
+                    routine[day].push_back({ex.name, sets_dist(gen)});
+                    if (ex.is_leg) leg_count++;
+                    break;
+                }
+            }
+        }
+
+        shuffle(isolations.begin(), isolations.end(), gen);
+        for (const auto& ex : isolations) {
+            if (critical_exercises.count(ex.name) && used_exercises.insert(ex.name).second && (!ex.is_leg || leg_count < 2)) {
+                bool valid = true;
+                for (const auto& muscle : ex.primary) {
+                    if (is_muscle_recently_used(routine, day, muscle, exercises, profile)) {
+                        valid = false;
+                        break;
+                    }
+                }
+                if (valid) {
+                    uniform_int_distribution<> sets_dist(MIN_SETS + 1, MAX_SETS);
+                    routine[day].push_back({ex.name, sets_dist(gen)});
+                    if (ex.is_leg) leg_count++;
+                }
+            }
+        }
+
+        int target_exercises = isolation_dist(gen);
+        for (const auto& ex : isolations) {
+            if (used_exercises.size() >= target_exercises) break;
+            if (used_exercises.insert(ex.name).second && (!ex.is_leg || leg_count < 2)) {
+                bool valid = true;
+                for (const auto& muscle : ex.primary) {
+                    if (is_muscle_recently_used(routine, day, muscle, exercises, profile)) {
+                        valid = false;
+                        break;
+                    }
+                }
+                if (valid) {
+                    uniform_int_distribution<> sets_dist(MIN_SETS + 1, MAX_SETS);
+                    routine[day].push_back({ex.name, sets_dist(gen)});
+                    if (ex.is_leg) leg_count++;
+                }
+            }
+        }
+    }
+    return routine;
+}
+
+// Convert vector to string
+string vector_to_string(const vector<string>& vec) {
+    stringstream ss;
+    for (size_t i = 0; i < vec.size(); ++i) {
+        if (i != 0) ss << ", ";
+        ss << vec[i];
+    }
+    return ss.str();
+}
+
+// Save to Markdown file
+void save_to_file(const vector<vector<RoutineEntry>>& routine, const vector<Exercise>& exercises, const unordered_map<string, MuscleGroup>& mav_targets, const string& filename) {
+    ofstream out(filename);
+    if (!out) {
+        cerr << "Error opening file" << endl;
+        return;
+    }
+
+    out << "# 6-Day Workout Routine\n\n";
+    out << "Each session starts with one compound exercise, followed by additional sets to target specific muscle groups.\n\n";
+
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        out << "## Day " << (day + 1) << ": " << routine[day].size() << " Exercises\n";
+        for (size_t i = 0; i < routine[day].size(); ++i) {
+            const auto& entry = routine[day][i];
+            auto it = find_if(exercises.begin(), exercises.end(), [&](const Exercise& e) { return e.name == entry.exercise; });
+            if (it == exercises.end()) continue;
+            const Exercise& ex = *it;
+            string set_type = (i == 0 && ex.is_compound) ? "Straight Sets (Compound First)" : "Straight Sets";
+            out << "- **" << set_type << "**: " << entry.exercise << " - " << entry.sets << " sets of 8-12 reps *(";
+            stringstream ss;
+            ss << "*" << vector_to_string(ex.primary) << "*";
+            if (!ex.secondary.empty()) ss << ", secondary: " << vector_to_string(ex.secondary);
+            if (!ex.isometric.empty()) ss << ", isometric: " << vector_to_string(ex.isometric);
+            out << ss.str() << ")*\n";
+        }
+        out << "- **Time Estimate**: ";
+        double total_time = 0.0;
+        for (const auto& entry : routine[day]) {
+            total_time += entry.sets * TIME_PER_SET;
+        }
+        out << static_cast<int>(total_time) << " minutes\n\n";
+    }
+
+    out << "## Weekly Volume Breakdown\n";
+    auto volumes = compute_volumes(routine, exercises);
+    for (const auto& muscle : mav_targets) {
+        string name = muscle.first;
+        double target = muscle.second.target;
+        double upper_bound = muscle.second.upper_bound;
+        double vol = volumes.count(name) ? volumes[name] : 0.0;
+        string status = volume_deficit_weight(name) == 0.0 ? "not optimized" : (vol < target ? "below target" : (vol > upper_bound ? "exceeds upper bound" : "on target"));
+        out << "- **" << name << "**: " << fixed << setprecision(2) << vol << " sets (" << target << "-" << upper_bound << " sets – " << status << ")\n";
+    }
+    out.close();
+}
+
+// Function to run one annealing iteration at the state's temperature: propose a move, screen or
+// cost it, apply the Metropolis test and record the outcome; returns whether the best improved
+static bool anneal_step(AnnealingState& state,
+                        const vector<Exercise>& exercises,
+                        const unordered_map<string, MuscleGroup>& mav_targets,
+                        OptimizerTelemetry& telemetry,
+                        const OptimizerProfile* profile) {
+    int iter = state.iteration;
+    mt19937& gen = state.gen;
+    vector<vector<RoutineEntry>>& routine = state.routine;
+    OperatorSelector& selector = state.selector;
+    double temp = state.temperature;
+    double& current_cost = state.current_cost;
+    double& best_cost = state.best_cost;
+    map<string, double>& current_volumes = state.volumes;
+    bool new_best = false;
+
+    auto perturb_start = TelemetryClock::now();
+    int action = select_operator(selector, gen);
+    vector<vector<RoutineEntry>> new_routine = routine;
+    bool applied = perturb_routine(new_routine, exercises, mav_targets, action, gen, profile);
+    int unrepaired = applied ? repair_routine(new_routine, exercises, mav_targets, profile) : 0;
+    auto cost_start = TelemetryClock::now();
+
+    if (!applied) {
+        // Nothing changed, so skip the evaluation and give the operator no credit
+        update_operator(selector, action, 0.0);
+        telemetry.perturb_seconds += seconds_between(perturb_start, cost_start);
+        record_no_op(telemetry, action);
+    } else {
+        // Drawing the Metropolis number first fixes the acceptance threshold, so a proposal
+        // whose volume term alone cannot pass it is rejected without the full cost
+        double draw = uniform_real_distribution<>(0, 1)(gen);
+        map<string, double> new_volumes = proposal_volumes(routine, new_routine, current_volumes, exercises);
+        uint64_t new_hash = proposal_hash(routine, new_routine, state.hash);
+        double lower_bound = volume_penalty(new_volumes, mav_targets, state.deficit_weights, weights_for(profile).excess_volume);
+        if (lower_bound >= current_cost && exp((current_cost - lower_bound) / temp) <= draw) {
+            // A worse proposal earns no operator credit, same as a costed rejection would
+            update_operator(selector, action, 0.0);
+            telemetry.perturb_seconds += seconds_between(perturb_start, cost_start);
+            telemetry.cost_seconds += seconds_between(cost_start, TelemetryClock::now());
+            record_screened(telemetry, action);
+        } else {
+            double new_cost = cached_cost(*state.costs, new_hash, new_routine, mav_targets, exercises, profile, state.deficit_weights, &telemetry.cost_table_hits);
+            auto accept_start = TelemetryClock::now();
+
+            update_operator(selector, action, improvement_reward(current_cost, new_cost));
+            bool accepted = false;
+            bool improved = new_cost < current_cost;
+            if (improved || draw < exp((current_cost - new_cost) / temp)) {
+                routine = new_routine;
+                current_cost = new_cost;
+                current_volumes = new_volumes;
+                state.hash = new_hash;
+                accepted = true;
+                if (new_cost < best_cost) {
+                    best_cost = new_cost;
+                    state.best_routine = routine;
+                    new_best = true;
+                    optimizer_log() << "New best cost at iteration " << iter << ": " << best_cost << endl;
+                }
+            }
+            auto accept_end = TelemetryClock::now();
+            telemetry.perturb_seconds += seconds_between(perturb_start, cost_start);
+            telemetry.cost_seconds += seconds_between(cost_start, accept_start);
+            telemetry.accept_seconds += seconds_between(accept_start, accept_end);
+            record_move(telemetry, action, accepted, improved, unrepaired > 0);
+        }
+    }
+    record_sample(telemetry, iter, temp, current_cost, best_cost);
+
+    if (iter % 1000 == 0) {
+        optimizer_log() << "Iteration " << iter << ": Temp = " << temp << ", Best Cost = " << best_cost << endl;
+    }
+    return new_best;
+}
+
+// Function to pass progress to an observer: on a new best or every observer interval, subject
+// to its rate limit (a held-back best stays pending); the final report is always delivered
+void report_progress(ProgressObserver* progress, long iteration, double temperature, double current_cost, double best_cost,
+                     const vector<vector<RoutineEntry>>& best_routine, bool improved, bool final) {
+    if (!progress || !progress->callback) return;
+    progress->pending = progress->pending || improved;
+    bool due = final || progress->pending || (progress->interval > 0 && iteration % progress->interval == 0);
+    if (!due) return;
+    auto now = TelemetryClock::now();
+    if (!final && progress->started && seconds_between(progress->last_report, now) < progress->min_seconds) return;
+    progress->callback({iteration, temperature, current_cost, best_cost, &best_routine, progress->pending, final});
+    progress->pending = false;
+    progress->started = true;
+    progress->last_report = now;
+}
+
+// Function to set up a simulated annealing run: a repaired random routine, the starting
+// temperature and a fresh operator selector
+AnnealingState start_annealing(const vector<Exercise>& exercises,
+                               const unordered_map<string, MuscleGroup>& mav_targets,
+                               unsigned int seed,
+                               const OptimizerProfile* profile) {
+    AnnealingState state;
+    state.gen.seed(seed);
+    state.routine = initialize_routine(exercises, state.gen, profile);
+    repair_routine(state.routine, exercises, mav_targets, profile);
+    state.deficit_weights = resolve_deficit_weights(mav_targets, profile);
+    state.current_cost = compute_cost(state.routine, mav_targets, exercises, profile, state.deficit_weights);
+    state.volumes = compute_volumes(state.routine, exercises);
+    state.hash = routine_hash(state.routine);
+    state.costs = make_cost_table();
+    state.best_cost = state.current_cost;
+    state.best_routine = state.routine;
+    state.selector = make_operator_selector(NUM_MOVE_TYPES);
+    return state;
+}
+
+// Function to run simulated annealing from the given state to SA_ITERATIONS, writing a checkpoint
+// every checkpoints->interval iterations when checkpoints is given
+vector<vector<RoutineEntry>> run_annealing(AnnealingState& state,
+                                           const vector<Exercise>& exercises,
+                                           const unordered_map<string, MuscleGroup>& mav_targets,
+                                           OptimizerTelemetry& telemetry,
+                                           const OptimizerProfile* profile,
+                                           const CheckpointOptions* checkpoints,
+                                           ProgressObserver* progress) {
+    optimizer_log() << "Starting optimization..." << endl;
+    while (state.iteration < SA_ITERATIONS) {
+        bool improved = anneal_step(state, exercises, mav_targets, telemetry, profile);
+        state.temperature *= COOLING_RATE;
+        ++state.iteration;
+        report_progress(progress, state.iteration, state.temperature, state.current_cost, state.best_cost, state.best_routine, improved);
+        if (checkpoints && checkpoints->interval > 0 && state.iteration % checkpoints->interval == 0) {
+            save_checkpoint(state, telemetry, exercises, checkpoints->filename);
+        }
+    }
+    state.best_cost = allocate_sets(state.best_routine, mav_targets, exercises, profile);
+    report_progress(progress, state.iteration, state.temperature, state.current_cost, state.best_cost, state.best_routine, false, true);
+    optimizer_log() << "Optimization complete. Final best cost: " << state.best_cost << endl;
+    return state.best_routine;
+}
+
+// Optimize routine with simulated annealing
+vector<vector<RoutineEntry>> optimize_routine(const vector<Exercise>& exercises, 
+                                              const unordered_map<string, MuscleGroup>& mav_targets,
+                                              OptimizerTelemetry& telemetry,
+                                              unsigned int seed,
+                                              const OptimizerProfile* profile,
+                                              const CheckpointOptions* checkpoints,
+                                              ProgressObserver* progress) {
+    AnnealingState state = start_annealing(exercises, mav_targets, seed, profile);
+    return run_annealing(state, exercises, mav_targets, telemetry, profile, checkpoints, progress);
+}
+
+// Function to continue a checkpointed run exactly where it stopped (the catalog, targets and
+// profile must be the ones it was started with); returns an empty routine if the checkpoint
+// cannot be loaded
+vector<vector<RoutineEntry>> resume_routine(const vector<Exercise>& exercises,
+                                            const unordered_map<string, MuscleGroup>& mav_targets,
+                                            OptimizerTelemetry& telemetry,
+                                            const string& checkpoint_file,
+                                            const OptimizerProfile* profile,
+                                            const CheckpointOptions* checkpoints,
+                                            ProgressObserver* progress) {
+    AnnealingState state;
+    if (!load_checkpoint(state, telemetry, exercises, checkpoint_file)) return {};
+    state.hash = routine_hash(state.routine);
+    state.costs = make_cost_table();
+    state.deficit_weights = resolve_deficit_weights(mav_targets, profile);
+    optimizer_log() << "Resuming optimization at iteration " << state.iteration << endl;
+    return run_annealing(state, exercises, mav_targets, telemetry, profile, checkpoints, progress);
+}
+
+// Function to anneal against a wall-clock budget instead of an iteration count. Setup times one
+// set allocation on the starting routine, and annealing stops that long before the deadline so
+// the final allocate_sets fits in the budget. The temperature falls geometrically from
+// INITIAL_TEMPERATURE to DEADLINE_FINAL_TEMPERATURE over the annealing span, and the best
+// routine so far is returned once the budget is spent. The overrun is at most one iteration
+// or one day's set enumeration plus the final costing.
+AnytimeResult optimize_routine_within(const vector<Exercise>& exercises,
+                                      const unordered_map<string, MuscleGroup>& mav_targets,
+                                      OptimizerTelemetry& telemetry,
+                                      unsigned int seed,
+                                      double budget_seconds,
+                                      const OptimizerProfile* profile,
+                                      ProgressObserver* progress) {
+    auto start = TelemetryClock::now();
+    auto deadline = start + chrono::duration_cast<TelemetryClock::duration>(chrono::duration<double>(budget_seconds));
+    AnnealingState state = start_annealing(exercises, mav_targets, seed, profile);
+    auto allocation_start = TelemetryClock::now();
+    vector<vector<RoutineEntry>> trial = state.routine;
+    allocate_sets(trial, mav_targets, exercises, profile, &deadline);
+    auto anneal_start = TelemetryClock::now();
+    auto anneal_end = deadline - (anneal_start - allocation_start);
+    double span = max(seconds_between(anneal_start, anneal_end), 1e-9);
+    double log_ratio = log(DEADLINE_FINAL_TEMPERATURE / INITIAL_TEMPERATURE);
+
+    optimizer_log() << "Starting optimization with a " << budget_seconds << " s budget..." << endl;
+    for (auto now = anneal_start; now < anneal_end; now = TelemetryClock::now()) {
+        state.temperature = INITIAL_TEMPERATURE * exp(log_ratio * seconds_between(anneal_start, now) / span);
+        bool improved = anneal_step(state, exercises, mav_targets, telemetry, profile);
+        ++state.iteration;
+        report_progress(progress, state.iteration, state.temperature, state.current_cost, state.best_cost, state.best_routine, improved);
+    }
+    state.best_cost = allocate_sets(state.best_routine, mav_targets, exercises, profile, &deadline);
+    report_progress(progress, state.iteration, state.temperature, state.current_cost, state.best_cost, state.best_routine, false, true);
+    AnytimeResult result;
+    result.routine = state.best_routine;
+    result.cost = state.best_cost;
+    result.iterations = state.iteration;
+    result.seconds = seconds_between(start, TelemetryClock::now());
+    optimizer_log() << "Optimization complete after " << result.iterations << " iterations in " << result.seconds
+         << " s. Final best cost: " << result.cost << endl;
+    return result;
+}
+
+// Check a routine against the optimizer's rules; returns one message per violation
+vector<string> check_routine(const vector<vector<RoutineEntry>>& routine, const vector<Exercise>& exercises, const OptimizerProfile* profile) {
+    vector<string> violations;
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        string label = "Day " + to_string(day + 1);
+        set<string> day_exercises;
+        int leg_exercises = 0;
+        double day_time = 0.0;
+        for (const auto& entry : routine[day]) {
+            if (!day_exercises.insert(entry.exercise).second) {
+                violations.push_back(label + ": " + entry.exercise + " repeated");
+            }
+            auto ex = find_if(exercises.begin(), exercises.end(), [&](const Exercise& e) { return e.name == entry.exercise; });
+            if (ex == exercises.end()) {
+                violations.push_back(label + ": unknown exercise " + entry.exercise);
+                continue;
+            }
+            if (ex->is_leg) leg_exercises++;
+            if (entry.sets < MIN_SETS || entry.sets > MAX_SETS) {
+                violations.push_back(label + ": " + entry.exercise + " has " + to_string(entry.sets) + " sets");
+            }
+            day_time += entry.sets * TIME_PER_SET;
+            for (const auto& muscle : ex->primary) {
+                if (is_muscle_recently_used(routine, day, muscle, exercises, profile)) {
+                    violations.push_back(label + ": " + muscle + " not recovered for " + entry.exercise);
+                }
+            }
+        }
+        if (routine[day].size() < MIN_EXERCISES_PER_DAY || routine[day].size() > MAX_EXERCISES_PER_DAY) {
+            violations.push_back(label + ": " + to_string(routine[day].size()) + " exercises");
+        }
+        if (leg_exercises > 2) {
+            violations.push_back(label + ": " + to_string(leg_exercises) + " leg exercises");
+        }
+        if (day_time > MAX_TIME_PER_DAY) {
+            violations.push_back(label + ": " + to_string(day_time) + " minutes");
+        }
+    }
+    return violations;
+}
@@ -0,0 +1,153 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <string>
+#include <random>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include "telemetry.h"
+#include "operator_selection.h"
+#include "cost_weights.h"
+#include "transposition.h"
+
+using namespace std;
+
+// Constants
+const int TOTAL_DAYS = 6;
+const double TIME_PER_SET = 5.0; // minutes per set
+const int MIN_EXERCISES_PER_DAY = 3;
+const int MAX_EXERCISES_PER_DAY = 6;
+const int MIN_SETS = 2;
+const int MAX_SETS = 5;
+const double MAX_TIME_PER_DAY = 50.0; // minutes
+
+// Simulated annealing schedule
+const int SA_ITERATIONS = 75000;
+const double INITIAL_TEMPERATURE = 1500.0;
+const double COOLING_RATE = 0.993;
+const double DEADLINE_FINAL_TEMPERATURE = 1.0;  // Reached at the deadline by optimize_routine_within
+
+// Struct for an exercise
+struct Exercise {
+    string name;
+    vector<string> primary;
+    vector<string> secondary;
+    vector<string> isometric;
+    bool is_compound;
+    bool is_leg;
+};
+
+// Struct for muscle group targets
+struct MuscleGroup {
+    double target;
+    double upper_bound;
+};
+
+// Struct for routine entry
+struct RoutineEntry {
+    string exercise;
+    int sets;
+};
+
+// Per-member overrides of the built-in recovery table and deficit weights; muscles not listed
+// keep the defaults. Functions taking a profile pointer use the defaults when it is null.
+struct OptimizerProfile {
+    unordered_map<string, int> recovery_days;
+    optional<CostWeights> weights;    // Penalty weights for this member; the active cost_weights when empty
+};
+
+// Full state of a simulated annealing run, enough to continue it exactly (see checkpoint.h)
+struct AnnealingState {
+    int iteration = 0;                // Next iteration to run
+    double temperature = INITIAL_TEMPERATURE;
+    double current_cost = 0.0;
+    double best_cost = 0.0;
+    vector<vector<RoutineEntry>> routine;
+    vector<vector<RoutineEntry>> best_routine;
+    map<string, double> volumes;      // Volumes of routine, kept incrementally
+    OperatorSelector selector;
+    mt19937 gen;
+    uint64_t hash = 0;                // Zobrist hash of routine, kept incrementally (not checkpointed)
+    shared_ptr<CostTable> costs;      // Costs of routines already seen this run (not checkpointed)
+    vector<double> deficit_weights;   // resolve_deficit_weights for this run (not checkpointed)
+};
+
+// Struct to hold checkpoint settings: the state is written to filename every interval iterations
+struct CheckpointOptions {
+    string filename;
+    int interval = 1000;
+};
+
+// Struct to hold one progress report; best_routine is only valid during the callback
+struct ProgressView {
+    long iteration;              // Iterations (generations for the genetic engine) completed
+    double temperature;          // 0 for engines without one
+    double current_cost;
+    double best_cost;
+    const vector<vector<RoutineEntry>>* best_routine;
+    bool improved;               // A new best since the previous report
+    bool final;                  // The run has finished
+};
+
+// Struct to hold a progress callback. It is invoked on each new best and every `interval`
+// iterations, but at most once per min_seconds; a new best held back by that limit is sent as
+// soon as the window reopens, and the final report is always sent.
+struct ProgressObserver {
+    function<void(const ProgressView&)> callback;
+    long interval = 1000;        // 0 = new bests only
+    double min_seconds = 0.05;
+    bool pending = false;        // Delivery state, managed by report_progress
+    bool started = false;
+    TelemetryClock::time_point last_report;
+};
+
+// Struct to hold the outcome of a deadline-bounded run
+struct AnytimeResult {
+    vector<vector<RoutineEntry>> routine;  // Best routine found by the deadline
+    double cost = 0.0;
+    long iterations = 0;
+    double seconds = 0.0;                  // Wall time used, setup included
+};
+
+// Catalog used by the simulated annealing optimizer (defined in optimizer.cpp)
+extern unordered_map<string, int> muscle_recovery_days;
+extern vector<Exercise> exercises;
+extern unordered_map<string, MuscleGroup> mav_targets;
+
+ostream& optimizer_log();
+ostream* set_optimizer_log(ostream* log);
+bool is_muscle_recently_used(const vector<vector<RoutineEntry>>& routine, int current_day, const string& muscle, const vector<Exercise>& exercises, const OptimizerProfile* profile = nullptr);
+void add_day_volumes(map<string, double>& volumes, const vector<RoutineEntry>& day_entries, const vector<Exercise>& exercises, double sign);
+map<string, double> compute_volumes(const vector<vector<RoutineEntry>>& routine, const vector<Exercise>& exercises);
+map<string, double> proposal_volumes(const vector<vector<RoutineEntry>>& routine, const vector<vector<RoutineEntry>>& proposal, const map<string, double>& volumes, const vector<Exercise>& exercises);
+int recovery_days_for(const string& muscle, const OptimizerProfile* profile = nullptr);
+const CostWeights& weights_for(const OptimizerProfile* profile);
+double volume_deficit_weight(const string& muscle, const OptimizerProfile* profile = nullptr);
+vector<double> resolve_deficit_weights(const unordered_map<string, MuscleGroup>& mav_targets, const OptimizerProfile* profile = nullptr);
+double volume_penalty(const map<string, double>& volumes, const unordered_map<string, MuscleGroup>& mav_targets, const vector<double>& deficit_weights, double excess_weight);
+double compute_cost(const vector<vector<RoutineEntry>>& routine, const unordered_map<string, MuscleGroup>& mav_targets, const vector<Exercise>& exercises, const OptimizerProfile* profile = nullptr);
+double compute_cost(const vector<vector<RoutineEntry>>& routine, const unordered_map<string, MuscleGroup>& mav_targets, const vector<Exercise>& exercises, const OptimizerProfile* profile, const vector<double>& deficit_weights);
+uint64_t routine_hash(const vector<vector<RoutineEntry>>& routine);
+uint64_t proposal_hash(const vector<vector<RoutineEntry>>& routine, const vector<vector<RoutineEntry>>& proposal, uint64_t hash);
+double cached_cost(CostTable& table, uint64_t hash, const vector<vector<RoutineEntry>>& routine, const unordered_map<string, MuscleGroup>& mav_targets, const vector<Exercise>& exercises, const OptimizerProfile* profile, const vector<double>& deficit_weights, long* hits = nullptr);
+double allocate_sets(vector<vector<RoutineEntry>>& routine, const unordered_map<string, MuscleGroup>& mav_targets, const vector<Exercise>& exercises, const OptimizerProfile* profile = nullptr, const TelemetryClock::time_point* deadline = nullptr);
+vector<Exercise> candidate_exercises(const vector<vector<RoutineEntry>>& routine, int day, const vector<Exercise>& exercises, const vector<string>& under_target_muscles, const OptimizerProfile* profile = nullptr);
+bool perturb_routine(vector<vector<RoutineEntry>>& routine, const vector<Exercise>& exercises, const unordered_map<string, MuscleGroup>& mav_targets, int action, mt19937& gen, const OptimizerProfile* profile = nullptr);
+int repair_day(vector<vector<RoutineEntry>>& routine, int day, map<string, double>& volumes, const vector<Exercise>& exercises, const unordered_map<string, MuscleGroup>& mav_targets, const OptimizerProfile* profile = nullptr);
+int repair_routine(vector<vector<RoutineEntry>>& routine, const vector<Exercise>& exercises, const unordered_map<string, MuscleGroup>& mav_targets, const OptimizerProfile* profile = nullptr);
+vector<vector<RoutineEntry>> initialize_routine(const vector<Exercise>& exercises, mt19937& gen, const OptimizerProfile* profile = nullptr);
+string vector_to_string(const vector<string>& vec);
+void save_to_file(const vector<vector<RoutineEntry>>& routine, const vector<Exercise>& exercises, const unordered_map<string, MuscleGroup>& mav_targets, const string& filename);
+AnnealingState start_annealing(const vector<Exercise>& exercises, const unordered_map<string, MuscleGroup>& mav_targets, unsigned int seed, const OptimizerProfile* profile = nullptr);
+void report_progress(ProgressObserver* progress, long iteration, double temperature, double current_cost, double best_cost, const vector<vector<RoutineEntry>>& best_routine, bool improved, bool final = false);
+vector<vector<RoutineEntry>> run_annealing(AnnealingState& state, const vector<Exercise>& exercises, const unordered_map<string, MuscleGroup>& mav_targets, OptimizerTelemetry& telemetry, const OptimizerProfile* profile = nullptr, const CheckpointOptions* checkpoints = nullptr, ProgressObserver* progress = nullptr);
+vector<vector<RoutineEntry>> optimize_routine(const vector<Exercise>& exercises, const unordered_map<string, MuscleGroup>& mav_targets, OptimizerTelemetry& telemetry, unsigned int seed, const OptimizerProfile* profile = nullptr, const CheckpointOptions* checkpoints = nullptr, ProgressObserver* progress = nullptr);
+AnytimeResult optimize_routine_within(const vector<Exercise>& exercises, const unordered_map<string, MuscleGroup>& mav_targets, OptimizerTelemetry& telemetry, unsigned int seed, double budget_seconds, const OptimizerProfile* profile = nullptr, ProgressObserver* progress = nullptr);
+vector<vector<RoutineEntry>> resume_routine(const vector<Exercise>& exercises, const unordered_map<string, MuscleGroup>& mav_targets, OptimizerTelemetry& telemetry, const string& checkpoint_file, const OptimizerProfile* profile = nullptr, const CheckpointOptions* checkpoints = nullptr, ProgressObserver* progress = nullptr);
+vector<string> check_routine(const vector<vector<RoutineEntry>>& routine, const vector<Exercise>& exercises, const OptimizerProfile* profile = nullptr);
+
+#endif // OPTIMIZER_H
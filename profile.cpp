@@ -0,0 +1,321 @@
+#include "profile.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+// Profile files
+//
+// CSV, one setting per row, with each member's rows contiguous (an optional header row
+// starting with user_id is skipped):
+//   user_id,kind,name,value,upper_bound
+//   m1,target,Chest,14,20        upper_bound may be left empty to keep the default spread
+//   m1,recovery,Quads,3,
+//   m1,weight,Quads,20000,       deficit weight; 0 stops optimizing the muscle
+//   m1,penalty,overtime,6000,    penalty weight by cost_weights key (see cost_weights.cpp)
+//   m1,exclude,Squat,,
+//
+// JSONL, one member per line:
+//   {"user_id": "m1", "targets": {"Chest": 14, "Quads": {"target": 12, "upper_bound": 18}},
+//    "recovery_days": {"Quads": 3}, "weights": {"Quads": 20000}, "penalties": {"overtime": 6000},
+//    "excluded": ["Squat"]}
+
+// Function to create a profile with the built-in targets and no overrides
+UserProfile default_profile(const string& user_id) {
+    UserProfile profile;
+    profile.user_id = user_id;
+    profile.mav_targets = mav_targets;
+    return profile;
+}
+
+// Function to drop the member's excluded exercises from a catalog
+vector<Exercise> profile_exercises(const UserProfile& profile, const vector<Exercise>& exercises) {
+    vector<Exercise> result;
+    for (const auto& ex : exercises) {
+        if (!profile.excluded_exercises.count(ex.name)) result.push_back(ex);
+    }
+    return result;
+}
+
+// Function to pick the format from the file extension (.jsonl or .json, otherwise CSV)
+ProfileFormat profile_format_for(const string& filename) {
+    auto ends_with = [&](const string& suffix) {
+        return filename.size() >= suffix.size() && filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    return ends_with(".jsonl") || ends_with(".json") ? ProfileFormat::Jsonl : ProfileFormat::Csv;
+}
+
+ProfileStream open_profile_stream(istream& in, ProfileFormat format) {
+    ProfileStream stream;
+    stream.in = &in;
+    stream.format = format;
+    return stream;
+}
+
+// Function to set a target, keeping the default spread to the upper bound when none is given
+static void set_target(UserProfile& profile, const string& muscle, double target, bool has_upper, double upper) {
+    double spread = 8.0;
+    auto it = profile.mav_targets.find(muscle);
+    if (it != profile.mav_targets.end()) spread = it->second.upper_bound - it->second.target;
+    profile.mav_targets[muscle] = {target, has_upper ? upper : target + spread};
+}
+
+// Function to get the member's own penalty weights, copied from the stream's base set on first use
+static CostWeights& member_weights(const ProfileStream& stream, UserProfile& profile) {
+    if (!profile.overrides.weights) profile.overrides.weights = *stream.base_weights;
+    return *profile.overrides.weights;
+}
+
+// Function to set one of the member's penalty weights
+static bool set_penalty(const ProfileStream& stream, UserProfile& profile, const string& key, double value) {
+    return set_cost_weight(member_weights(stream, profile), key, value);
+}
+
+static bool parse_number(const string& text, double& value) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    value = strtod(text.c_str(), &end);
+    return end && *end == '\0';
+}
+
+static void warn(const ProfileStream& stream, const string& message) {
+    cerr << "Profile line " << stream.line << ": " << message << endl;
+}
+
+static vector<string> split_csv(const string& line) {
+    vector<string> fields;
+    string field;
+    istringstream in(line);
+    while (getline(in, field, ',')) {
+        field.erase(0, field.find_first_not_of(" \t\r"));
+        field.erase(field.find_last_not_of(" \t\r") + 1);
+        fields.push_back(field);
+    }
+    if (!line.empty() && line.back() == ',') fields.push_back("");
+    return fields;
+}
+
+// Function to apply one CSV setting row to a profile
+static void apply_csv_row(ProfileStream& stream, UserProfile& profile, const vector<string>& row) {
+    if (row.size() < 3) {
+        warn(stream, "expected user_id,kind,name[,value[,upper_bound]]");
+        return;
+    }
+    const string& kind = row[1];
+    const string& name = row[2];
+    double value = 0.0;
+    double upper = 0.0;
+    bool has_value = row.size() > 3 && parse_number(row[3], value);
+    bool has_upper = row.size() > 4 && parse_number(row[4], upper);
+    if (kind == "exclude") {
+        profile.excluded_exercises.insert(name);
+    } else if (!has_value) {
+        warn(stream, "missing or invalid value for " + kind + " " + name);
+    } else if (kind == "target") {
+        set_target(profile, name, value, has_upper, upper);
+    } else if (kind == "recovery") {
+        profile.overrides.recovery_days[name] = static_cast<int>(value);
+    } else if (kind == "weight") {
+        member_weights(stream, profile).deficit_weights[name] = value;
+    } else if (kind == "penalty") {
+        if (!set_penalty(stream, profile, name, value)) warn(stream, "invalid penalty " + name);
+    } else {
+        warn(stream, "unknown setting kind " + kind);
+    }
+}
+
+// Function to read the next member's contiguous block of CSV rows
+static bool next_csv_profile(ProfileStream& stream, UserProfile& profile) {
+    vector<string> row;
+    if (stream.has_pending) {
+        row = stream.pending;
+        stream.has_pending = false;
+    } else {
+        string line;
+        while (true) {
+            if (!getline(*stream.in, line)) return false;
+            stream.line++;
+            row = split_csv(line);
+            if (row.empty() || row[0].empty() || row[0][0] == '#') continue;
+            if (stream.line == 1 && row[0] == "user_id") continue;
+            break;
+        }
+    }
+    profile = default_profile(row[0]);
+    apply_csv_row(stream, profile, row);
+    string line;
+    while (getline(*stream.in, line)) {
+        stream.line++;
+        row = split_csv(line);
+        if (row.empty() || row[0].empty() || row[0][0] == '#') continue;
+        if (row[0] != profile.user_id) {
+            stream.pending = row;
+            stream.has_pending = true;
+            break;
+        }
+        apply_csv_row(stream, profile, row);
+    }
+    return true;
+}
+
+// Minimal JSON value for one JSONL record (objects, arrays, strings, numbers, literals)
+struct JsonValue {
+    enum Type { Null, Bool, Number, String, Array, Object } type = Null;
+    double number = 0.0;
+    string text;
+    vector<JsonValue> items;
+    vector<pair<string, JsonValue>> members;
+};
+
+struct JsonParser {
+    const string& s;
+    size_t pos = 0;
+
+    void skip() {
+        while (pos < s.size() && isspace(static_cast<unsigned char>(s[pos]))) pos++;
+    }
+    bool consume(char c) {
+        skip();
+        if (pos < s.size() && s[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+    bool parse_string(string& out) {
+        if (!consume('"')) return false;
+        out.clear();
+        while (pos < s.size() && s[pos] != '"') {
+            char c = s[pos++];
+            if (c == '\\' && pos < s.size()) {
+                char e = s[pos++];
+                if (e == 'n') c = '\n';
+                else if (e == 't') c = '\t';
+                else if (e == 'u') {
+                    // Profiles only use ASCII names; keep non-ASCII escapes as '?'
+                    pos = min(s.size(), pos + 4);
+                    c = '?';
+                } else c = e;
+            }
+            out += c;
+        }
+        return consume('"');
+    }
+    bool parse(JsonValue& value) {
+        skip();
+        if (pos >= s.size()) return false;
+        char c = s[pos];
+        if (c == '{') {
+            pos++;
+            value.type = JsonValue::Object;
+            if (consume('}')) return true;
+            do {
+                string key;
+                JsonValue member;
+                if (!parse_string(key) || !consume(':') || !parse(member)) return false;
+                value.members.push_back({key, member});
+            } while (consume(','));
+            return consume('}');
+        }
+        if (c == '[') {
+            pos++;
+            value.type = JsonValue::Array;
+            if (consume(']')) return true;
+            do {
+                JsonValue item;
+                if (!parse(item)) return false;
+                value.items.push_back(item);
+            } while (consume(','));
+            return consume(']');
+        }
+        if (c == '"') {
+            value.type = JsonValue::String;
+            return parse_string(value.text);
+        }
+        for (const char* literal : {"true", "false", "null"}) {
+            size_t n = string(literal).size();
+            if (s.compare(pos, n, literal) == 0) {
+                pos += n;
+                value.type = literal[0] == 'n' ? JsonValue::Null : JsonValue::Bool;
+                value.number = literal[0] == 't';
+                return true;
+            }
+        }
+        char* end = nullptr;
+        value.number = strtod(s.c_str() + pos, &end);
+        if (end == s.c_str() + pos) return false;
+        value.type = JsonValue::Number;
+        pos = end - s.c_str();
+        return true;
+    }
+};
+
+// Function to apply a parsed JSONL record to a profile
+static void apply_json_profile(ProfileStream& stream, UserProfile& profile, const JsonValue& record) {
+    for (const auto& [key, value] : record.members) {
+        if (key == "targets" && value.type == JsonValue::Object) {
+            for (const auto& [muscle, target] : value.members) {
+                if (target.type == JsonValue::Number) {
+                    set_target(profile, muscle, target.number, false, 0.0);
+                } else if (target.type == JsonValue::Array && target.items.size() == 2) {
+                    set_target(profile, muscle, target.items[0].number, true, target.items[1].number);
+                } else if (target.type == JsonValue::Object) {
+                    double t = 0.0, upper = 0.0;
+                    bool has_target = false, has_upper = false;
+                    for (const auto& [field, number] : target.members) {
+                        if (field == "target") { t = number.number; has_target = true; }
+                        if (field == "upper_bound") { upper = number.number; has_upper = true; }
+                    }
+                    if (has_target) set_target(profile, muscle, t, has_upper, upper);
+                    else warn(stream, "target for " + muscle + " has no \"target\"");
+                } else {
+                    warn(stream, "invalid target for " + muscle);
+                }
+            }
+        } else if (key == "recovery_days" && value.type == JsonValue::Object) {
+            for (const auto& [muscle, days] : value.members) profile.overrides.recovery_days[muscle] = static_cast<int>(days.number);
+        } else if (key == "weights" && value.type == JsonValue::Object) {
+            for (const auto& [muscle, weight] : value.members) member_weights(stream, profile).deficit_weights[muscle] = weight.number;
+        } else if (key == "penalties" && value.type == JsonValue::Object) {
+            for (const auto& [name, weight] : value.members) {
+                if (weight.type != JsonValue::Number || !set_penalty(stream, profile, name, weight.number)) warn(stream, "invalid penalty " + name);
+            }
+        } else if (key == "excluded" && value.type == JsonValue::Array) {
+            for (const auto& item : value.items) {
+                if (item.type == JsonValue::String) profile.excluded_exercises.insert(item.text);
+            }
+        }
+    }
+}
+
+// Function to read the next JSONL record, skipping blank and malformed lines
+static bool next_jsonl_profile(ProfileStream& stream, UserProfile& profile) {
+    string line;
+    while (getline(*stream.in, line)) {
+        stream.line++;
+        if (line.find_first_not_of(" \t\r") == string::npos) continue;
+        JsonValue record;
+        JsonParser parser{line};
+        if (!parser.parse(record) || record.type != JsonValue::Object) {
+            warn(stream, "not a JSON object");
+            continue;
+        }
+        auto id = find_if(record.members.begin(), record.members.end(), [](const pair<string, JsonValue>& m) {
+            return m.first == "user_id";
+        });
+        if (id == record.members.end() || id->second.type != JsonValue::String) {
+            warn(stream, "missing user_id");
+            continue;
+        }
+        profile = default_profile(id->second.text);
+        apply_json_profile(stream, profile, record);
+        return true;
+    }
+    return false;
+}
+
+// Function to read the next member profile; returns false at the end of the stream
+bool next_profile(ProfileStream& stream, UserProfile& profile) {
+    return stream.format == ProfileFormat::Jsonl ? next_jsonl_profile(stream, profile) : next_csv_profile(stream, profile);
+}
@@ -0,0 +1,37 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <istream>
+#include "optimizer.h"
+
+// Struct to hold one member's personalized targets, recovery, priorities and exclusions
+struct UserProfile {
+    string user_id;
+    unordered_map<string, MuscleGroup> mav_targets;  // built-in targets with the member's overrides
+    OptimizerProfile overrides;                      // recovery days, deficit and penalty weights
+    set<string> excluded_exercises;
+};
+
+enum class ProfileFormat { Csv, Jsonl };
+
+// Struct to hold the state of a streaming profile read. Only the profile being built and,
+// for CSV, one lookahead row are held in memory, so files of any size can be processed.
+struct ProfileStream {
+    istream* in;
+    ProfileFormat format;
+    long line = 0;
+    bool has_pending = false;
+    vector<string> pending;  // CSV row that started the next member
+    const CostWeights* base_weights = &cost_weights;  // Weights a member's penalty and weight rows start from
+};
+
+UserProfile default_profile(const string& user_id);
+vector<Exercise> profile_exercises(const UserProfile& profile, const vector<Exercise>& exercises);
+ProfileFormat profile_format_for(const string& filename);
+ProfileStream open_profile_stream(istream& in, ProfileFormat format);
+bool next_profile(ProfileStream& stream, UserProfile& profile);
+
+#endif // PROFILE_H
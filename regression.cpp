@@ -0,0 +1,97 @@
+#include "regression.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <map>
+#include <cstring>
+
+using namespace std;
+
+// Allowed drift from the recorded baselines before a case fails
+const double COST_TOLERANCE = 0.05;   // 5% above the recorded final cost
+const double TIME_TOLERANCE = 0.50;   // 50% above the recorded wall time...
+const double TIME_SLACK = 0.05;       // ...plus 50 ms of scheduling noise
+
+// Struct to hold one recorded baseline
+struct Baseline {
+    double cost;
+    double seconds;
+    size_t violations;
+};
+
+// Function to load baselines ("name cost seconds violations" per line, # comments)
+map<string, Baseline> load_baselines(const string& filename) {
+    map<string, Baseline> baselines;
+    ifstream in(filename);
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        istringstream fields(line);
+        string name;
+        Baseline baseline;
+        if (fields >> name >> baseline.cost >> baseline.seconds >> baseline.violations) baselines[name] = baseline;
+    }
+    return baselines;
+}
+
+// Function to record baselines from the current run
+bool save_baselines(const vector<RegressionResult>& results, const string& filename) {
+    ofstream out(filename);
+    if (!out) {
+        cerr << "Error opening file " << filename << endl;
+        return false;
+    }
+    out << "# Regression baselines: case, final cost, wall seconds, rule violations (fixed seeds, libstdc++ distributions)\n";
+    for (const auto& result : results) {
+        out << result.name << " " << setprecision(17) << result.cost << " " << setprecision(6) << result.seconds
+            << " " << result.violations.size() << "\n";
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    bool record = false;
+    string baseline_file = "regression_baselines.txt";
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--record") == 0) record = true;
+        else baseline_file = argv[i];
+    }
+
+    vector<RegressionResult> results = run_optimizer_cases();
+    vector<RegressionResult> generator_results = run_generator_cases();
+    results.insert(results.end(), generator_results.begin(), generator_results.end());
+
+    if (record) {
+        if (!save_baselines(results, baseline_file)) return 1;
+        cout << "Recorded " << results.size() << " baselines to " << baseline_file << "\n";
+    }
+
+    map<string, Baseline> baselines = load_baselines(baseline_file);
+    int failures = 0;
+    for (const auto& result : results) {
+        vector<string> problems = result.failures;
+        auto it = baselines.find(result.name);
+        if (it == baselines.end()) {
+            problems.push_back("no recorded baseline");
+        } else {
+            const Baseline& baseline = it->second;
+            if (result.cost > baseline.cost * (1.0 + COST_TOLERANCE) + 1e-9) {
+                problems.push_back("cost " + to_string(result.cost) + " regressed from " + to_string(baseline.cost));
+            }
+            if (result.seconds > baseline.seconds * (1.0 + TIME_TOLERANCE) + TIME_SLACK) {
+                problems.push_back("time " + to_string(result.seconds) + " s regressed from " + to_string(baseline.seconds) + " s");
+            }
+            if (result.violations.size() > baseline.violations) {
+                problems.push_back(to_string(result.violations.size()) + " rule violations, up from " + to_string(baseline.violations));
+                problems.insert(problems.end(), result.violations.begin(), result.violations.end());
+            }
+        }
+        cout << (problems.empty() ? "PASS " : "FAIL ") << result.name << ": cost " << result.cost
+             << ", " << result.violations.size() << " violations, " << fixed << setprecision(3) << result.seconds << " s\n" << defaultfloat << setprecision(6);
+        for (const auto& problem : problems) cout << "    " << problem << "\n";
+        if (!problems.empty()) ++failures;
+    }
+    cout << (results.size() - failures) << "/" << results.size() << " regression cases passed\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+#ifndef REGRESSION_H
+#define REGRESSION_H
+
+#include <string>
+#include <vector>
+
+// Struct to hold the outcome of one regression case. Rule violations may not exceed the count
+// recorded in the baseline; failures (e.g. a resumed run diverging) fail the case outright.
+struct RegressionResult {
+    std::string name;
+    double cost;
+    double seconds;
+    std::vector<std::string> violations;
+    std::vector<std::string> failures;
+};
+
+std::vector<RegressionResult> run_optimizer_cases();
+std::vector<RegressionResult> run_generator_cases();
+
+#endif // REGRESSION_H
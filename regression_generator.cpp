@@ -0,0 +1,54 @@
+#include "regression.h"
+#include "generator.h"
+#include "floor_schedule.h"
+#include <iostream>
+#include <sstream>
+#include <chrono>
+
+using namespace std;
+
+// Function to schedule day one of generated routines for a group sharing the default floor; the
+// cost is the session makespan in minutes, and only the scheduling is timed
+static RegressionResult run_floor_case(const string& name, int athletes, int day) {
+    vector<vector<Structure>> days;
+    ostringstream discard;
+    streambuf* saved = cout.rdbuf(discard.rdbuf());
+    for (int athlete = 0; athlete < athletes; ++athlete) {
+        unordered_map<int, vector<Structure>> routine;
+        unordered_map<int, double> day_times;
+        mt19937 g(101 + athlete);
+        generate_routine(g, routine, day_times);
+        days.push_back(routine[day]);
+    }
+    cout.rdbuf(saved);
+    GymFloor floor = default_gym_floor();
+    FloorSearchOptions options;
+    auto start = chrono::steady_clock::now();
+    FloorSchedule schedule = schedule_floor(days, floor, options);
+    auto end = chrono::steady_clock::now();
+    return {name, schedule.makespan, chrono::duration<double>(end - start).count(), check_floor_schedule(days, floor, schedule)};
+}
+
+// Function to run the greedy generator on the default catalog over several seeds
+vector<RegressionResult> run_generator_cases() {
+    unordered_map<string, Exercise> exercises_map;
+    for (const auto& ex : exercises) {
+        exercises_map[ex.name] = ex;
+    }
+    vector<RegressionResult> results;
+    for (unsigned int seed : {1u, 2u, 3u}) {
+        unordered_map<int, vector<Structure>> routine;
+        unordered_map<int, double> day_times;
+        mt19937 g(seed);
+        ostringstream discard;
+        streambuf* saved = cout.rdbuf(discard.rdbuf());
+        auto start = chrono::steady_clock::now();
+        generate_routine(g, routine, day_times);
+        auto end = chrono::steady_clock::now();
+        cout.rdbuf(saved);
+        results.push_back({"generator_default_seed" + to_string(seed), volume_deficit_cost(routine, exercises_map),
+                           chrono::duration<double>(end - start).count(), check_generated_routine(routine, exercises_map)});
+    }
+    results.push_back(run_floor_case("floor_40_athletes_day1", 40, 1));
+    return results;
+}
@@ -0,0 +1,234 @@
+#include "regression.h"
+#include "optimizer.h"
+#include "day_templates.h"
+#include "replan.h"
+#include "neighbor_batch.h"
+#include "genetic.h"
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+using namespace std;
+
+// Function to extend the default catalog with deterministic synthetic isolation and compound
+// exercises over the same muscle groups
+static vector<Exercise> synthetic_catalog(int extra_exercises, unsigned int seed) {
+    vector<Exercise> catalog = exercises;
+    vector<string> muscles;
+    for (const auto& [muscle, target] : mav_targets) muscles.push_back(muscle);
+    sort(muscles.begin(), muscles.end());
+    const vector<string> leg_muscles = {"Quads", "Hamstrings", "Glutes"};
+
+    mt19937 gen(seed);
+    uniform_int_distribution<> muscle_dist(0, muscles.size() - 1);
+    uniform_int_distribution<> secondary_count(0, 2);
+    uniform_real_distribution<> unit(0, 1);
+    for (int i = 0; i < extra_exercises; ++i) {
+        Exercise ex;
+        ex.name = "Synthetic " + to_string(i + 1);
+        ex.is_compound = unit(gen) < 0.25;
+        int primary_count = ex.is_compound ? 2 : 1;
+        while (static_cast<int>(ex.primary.size()) < primary_count) {
+            string muscle = muscles[muscle_dist(gen)];
+            if (find(ex.primary.begin(), ex.primary.end(), muscle) == ex.primary.end()) ex.primary.push_back(muscle);
+        }
+        for (int s = secondary_count(gen); s > 0; --s) {
+            string muscle = muscles[muscle_dist(gen)];
+            if (find(ex.primary.begin(), ex.primary.end(), muscle) == ex.primary.end() &&
+                find(ex.secondary.begin(), ex.secondary.end(), muscle) == ex.secondary.end()) {
+                ex.secondary.push_back(muscle);
+            }
+        }
+        ex.is_leg = any_of(ex.primary.begin(), ex.primary.end(), [&](const string& m) {
+            return find(leg_muscles.begin(), leg_muscles.end(), m) != leg_muscles.end();
+        });
+        catalog.push_back(ex);
+    }
+    return catalog;
+}
+
+// Function to run the simulated annealing optimizer on one catalog with a fixed seed
+static RegressionResult run_case(const string& name, const vector<Exercise>& catalog, unsigned int seed) {
+    OptimizerTelemetry telemetry;
+    ostringstream discard;
+    streambuf* saved = cout.rdbuf(discard.rdbuf());
+    auto start = chrono::steady_clock::now();
+    vector<vector<RoutineEntry>> routine = optimize_routine(catalog, mav_targets, telemetry, seed);
+    auto end = chrono::steady_clock::now();
+    cout.rdbuf(saved);
+    return {name, compute_cost(routine, mav_targets, catalog), chrono::duration<double>(end - start).count(),
+            check_routine(routine, catalog)};
+}
+
+// Function to run the batched optimizer, K proposals per step, on one catalog with a fixed seed
+static RegressionResult run_batched_case(const string& name, const vector<Exercise>& catalog, unsigned int seed, const BatchOptions& options) {
+    OptimizerTelemetry telemetry;
+    ostringstream discard;
+    streambuf* saved = cout.rdbuf(discard.rdbuf());
+    auto start = chrono::steady_clock::now();
+    vector<vector<RoutineEntry>> routine = optimize_routine_batched(catalog, mav_targets, telemetry, seed, options);
+    auto end = chrono::steady_clock::now();
+    cout.rdbuf(saved);
+    return {name, compute_cost(routine, mav_targets, catalog), chrono::duration<double>(end - start).count(),
+            check_routine(routine, catalog)};
+}
+
+// Function to score the same dense volume rows with the scalar and AVX2 volume kernels, which
+// must agree exactly. Rows are drawn between no volume and twice each muscle's upper bound, so
+// both the deficit and the excess terms are exercised. Without AVX2 only the scalar kernel runs.
+static RegressionResult run_volume_kernel_case(const string& name, const vector<Exercise>& catalog, unsigned int seed, size_t rows) {
+    VolumeKernel kernel = make_volume_kernel(catalog, mav_targets);
+    mt19937 rng(seed);
+    vector<double> volumes(rows * kernel.stride, 0.0);
+    for (size_t k = 0; k < rows; ++k) {
+        for (size_t m = 0; m < kernel.muscles.size(); ++m) {
+            volumes[k * kernel.stride + m] = uniform_real_distribution<double>(0.0, 2.0 * kernel.upper_bounds[m])(rng);
+        }
+    }
+    vector<double> scalar(rows);
+    vector<double> simd(rows);
+    auto start = chrono::steady_clock::now();
+    batch_volume_penalties_scalar(kernel, volumes.data(), rows, scalar.data());
+    bool has_avx2 = batch_volume_penalties_avx2(kernel, volumes.data(), rows, simd.data());
+    auto end = chrono::steady_clock::now();
+    vector<string> failures;
+    for (size_t k = 0; has_avx2 && k < rows && failures.empty(); ++k) {
+        if (simd[k] != scalar[k]) {
+            failures.push_back("row " + to_string(k) + ": AVX2 penalty " + to_string(simd[k]) + " differs from scalar " + to_string(scalar[k]));
+        }
+    }
+    double total = 0.0;
+    for (double penalty : scalar) total += penalty;
+    return {name, total, chrono::duration<double>(end - start).count(), {}, failures};
+}
+
+// Function to run the genetic engine on one catalog with a fixed seed
+static RegressionResult run_genetic_case(const string& name, const vector<Exercise>& catalog, unsigned int seed) {
+    GeneticOptions options;
+    options.seed = seed;
+    ostringstream discard;
+    streambuf* saved = cout.rdbuf(discard.rdbuf());
+    auto start = chrono::steady_clock::now();
+    vector<vector<RoutineEntry>> routine = optimize_routine_genetic(catalog, mav_targets, options);
+    auto end = chrono::steady_clock::now();
+    cout.rdbuf(saved);
+    return {name, compute_cost(routine, mav_targets, catalog), chrono::duration<double>(end - start).count(),
+            check_routine(routine, catalog)};
+}
+
+// Function to run the day-template optimizer on one catalog, including the library build
+static RegressionResult run_template_case(const string& name, const vector<Exercise>& catalog, unsigned int seed) {
+    auto start = chrono::steady_clock::now();
+    DayTemplateLibrary library = build_day_templates(catalog, mav_targets);
+    vector<vector<RoutineEntry>> routine = optimize_day_templates(library, seed);
+    auto end = chrono::steady_clock::now();
+    return {name, compute_cost(routine, mav_targets, catalog), chrono::duration<double>(end - start).count(),
+            check_routine(routine, catalog)};
+}
+
+// Function to re-plan a template routine after Squat becomes unavailable from day 3 on:
+// days 1-2 are done, and Leg Extension takes Squat's place with the same sets. Only the
+// re-plan itself is timed.
+static RegressionResult run_replan_case(const string& name, unsigned int seed) {
+    DayTemplateLibrary library = build_day_templates(exercises, mav_targets);
+    vector<vector<RoutineEntry>> routine = optimize_day_templates(library, seed);
+    ReplanConstraints constraints;
+    constraints.frozen_days = {0, 1};
+    constraints.removed = {{-1, "Squat"}};
+    for (int day = 2; day < TOTAL_DAYS; ++day) {
+        for (const auto& entry : routine[day]) {
+            if (entry.exercise == "Squat") constraints.pinned.push_back({day, {"Leg Extension", entry.sets}});
+        }
+    }
+    auto start = chrono::steady_clock::now();
+    vector<vector<RoutineEntry>> replanned = replan_routine(library, routine, constraints);
+    auto end = chrono::steady_clock::now();
+    if (replanned.empty()) return {name, 0.0, chrono::duration<double>(end - start).count(), {}, {"re-plan failed"}};
+    return {name, compute_cost(replanned, mav_targets, exercises), chrono::duration<double>(end - start).count(),
+            check_routine(replanned, exercises)};
+}
+
+// Function to interrupt a run and resume it: a run checkpointing every 30000 iterations leaves its
+// state at 60000, and resuming from there must reproduce the uninterrupted result exactly
+static RegressionResult run_resume_case(const string& name, unsigned int seed) {
+    const string filename = "regression_checkpoint.bin";
+    CheckpointOptions checkpoints{filename, 30000};
+    OptimizerTelemetry telemetry;
+    OptimizerTelemetry resumed_telemetry;
+    ostringstream discard;
+    streambuf* saved = cout.rdbuf(discard.rdbuf());
+    auto start = chrono::steady_clock::now();
+    vector<vector<RoutineEntry>> routine = optimize_routine(exercises, mav_targets, telemetry, seed, nullptr, &checkpoints);
+    vector<vector<RoutineEntry>> resumed = resume_routine(exercises, mav_targets, resumed_telemetry, filename);
+    auto end = chrono::steady_clock::now();
+    cout.rdbuf(saved);
+    remove(filename.c_str());
+    vector<string> failures;
+    double cost = compute_cost(routine, mav_targets, exercises);
+    if (resumed.empty() || compute_cost(resumed, mav_targets, exercises) != cost) {
+        failures.push_back("resumed run diverged from the uninterrupted run");
+    }
+    for (size_t day = 0; day < routine.size() && day < resumed.size(); ++day) {
+        for (size_t i = 0; i < routine[day].size(); ++i) {
+            if (i >= resumed[day].size() || routine[day][i].exercise != resumed[day][i].exercise || routine[day][i].sets != resumed[day][i].sets) {
+                failures.push_back("resumed routine differs on day " + to_string(day + 1));
+                break;
+            }
+        }
+    }
+    if (resumed_telemetry.iterations != telemetry.iterations) {
+        failures.push_back("resumed telemetry counted " + to_string(resumed_telemetry.iterations) + " iterations");
+    }
+    return {name, cost, chrono::duration<double>(end - start).count(), check_routine(resumed, exercises), failures};
+}
+
+// Function to run the optimizer against a wall-clock budget; overrunning the budget by more than
+// a fifth plus 5 ms fails the case, as does a final progress report that disagrees with the result
+static RegressionResult run_deadline_case(const string& name, unsigned int seed, double budget_seconds) {
+    OptimizerTelemetry telemetry;
+    ProgressObserver progress;
+    double reported_cost = -1.0;
+    progress.callback = [&](const ProgressView& view) {
+        if (view.final) reported_cost = compute_cost(*view.best_routine, mav_targets, exercises);
+    };
+    ostringstream discard;
+    streambuf* saved = cout.rdbuf(discard.rdbuf());
+    AnytimeResult result = optimize_routine_within(exercises, mav_targets, telemetry, seed, budget_seconds, nullptr, &progress);
+    cout.rdbuf(saved);
+    vector<string> failures;
+    if (result.seconds > budget_seconds * 1.2 + 0.005) {
+        failures.push_back("took " + to_string(result.seconds) + " s of a " + to_string(budget_seconds) + " s budget");
+    }
+    if (reported_cost != result.cost) {
+        failures.push_back("final progress report cost " + to_string(reported_cost) + " differs from the result");
+    }
+    return {name, compute_cost(result.routine, mav_targets, exercises), result.seconds, check_routine(result.routine, exercises), failures};
+}
+
+// Function to run the optimizer cases: the default catalog over several seeds, then larger synthetic catalogs
+vector<RegressionResult> run_optimizer_cases() {
+    vector<RegressionResult> results;
+    for (unsigned int seed : {1u, 2u, 3u}) {
+        results.push_back(run_case("optimizer_default_seed" + to_string(seed), exercises, seed));
+    }
+    for (int extra : {12, 36, 84}) {
+        vector<Exercise> catalog = synthetic_catalog(extra, 7);
+        results.push_back(run_case("optimizer_synthetic" + to_string(catalog.size()) + "_seed1", catalog, 1));
+    }
+    results.push_back(run_batched_case("batched8_default_seed1", exercises, 1, {8, BatchSelection::Metropolis}));
+    results.push_back(run_batched_case("batched8_best_of_k_synthetic48_seed1", synthetic_catalog(36, 7), 1, {8, BatchSelection::BestOfK}));
+    results.push_back(run_volume_kernel_case("volume_kernel_synthetic96_seed1", synthetic_catalog(84, 7), 1, 4096));
+    results.push_back(run_genetic_case("genetic_default_seed1", exercises, 1));
+    results.push_back(run_genetic_case("genetic_synthetic48_seed1", synthetic_catalog(36, 7), 1));
+    for (unsigned int seed : {1u, 2u, 3u}) {
+        results.push_back(run_template_case("templates_default_seed" + to_string(seed), exercises, seed));
+    }
+    results.push_back(run_template_case("templates_synthetic24_seed1", synthetic_catalog(12, 7), 1));
+    results.push_back(run_replan_case("replan_swap_default_seed1", 1));
+    results.push_back(run_resume_case("resume_default_seed1", 1));
+    results.push_back(run_deadline_case("deadline_50ms_default_seed1", 1, 0.05));
+    return results;
+}
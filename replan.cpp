@@ -0,0 +1,202 @@
+#include "replan.h"
+#include <iostream>
+#include <algorithm>
+
+// Function to count the entries a template adds, drops or re-sets relative to a planned day
+static int divergence(const DayTemplateLibrary& library, size_t t, const vector<RoutineEntry>& planned) {
+    int changes = 0;
+    int matched = 0;
+    for (uint32_t i = library.offset[t]; i < library.offset[t + 1]; ++i) {
+        const string& name = library.exercise_names[library.entry_exercise[i]];
+        auto it = find_if(planned.begin(), planned.end(), [&](const RoutineEntry& e) { return e.exercise == name; });
+        if (it == planned.end()) {
+            changes++;
+        } else {
+            matched++;
+            if (it->sets != library.entry_sets[i]) changes++;
+        }
+    }
+    return changes + (planned.size() - matched);
+}
+
+// Function to list the ways an edited day breaks the day rules check_routine enforces
+// (recovery aside, which depends on the rest of the week)
+static vector<string> day_violations(const DayTemplateLibrary& library, const vector<RoutineEntry>& entries) {
+    vector<string> violations;
+    vector<int> seen;
+    int leg_exercises = 0;
+    double day_time = 0.0;
+    for (const auto& entry : entries) {
+        int e = exercise_index(library, entry.exercise);
+        if (e < 0) {
+            violations.push_back("unknown exercise " + entry.exercise);
+            continue;
+        }
+        if (find(seen.begin(), seen.end(), e) != seen.end()) violations.push_back(entry.exercise + " repeated");
+        seen.push_back(e);
+        if (library.is_leg[e]) leg_exercises++;
+        if (entry.sets < MIN_SETS || entry.sets > MAX_SETS) {
+            violations.push_back(entry.exercise + " has " + to_string(entry.sets) + " sets");
+        }
+        day_time += entry.sets * TIME_PER_SET;
+    }
+    if (entries.size() < MIN_EXERCISES_PER_DAY || entries.size() > MAX_EXERCISES_PER_DAY) {
+        violations.push_back(to_string(entries.size()) + " exercises");
+    }
+    if (leg_exercises > 2) violations.push_back(to_string(leg_exercises) + " leg exercises");
+    if (day_time > MAX_TIME_PER_DAY) violations.push_back(to_string(day_time) + " minutes");
+    return violations;
+}
+
+// Function to apply a day's changes to the planned day itself: removed exercises are dropped,
+// each pin replaces any planned entry for its exercise, and unpinned entries are dropped from
+// the end until the legs, entry count and time fit. Returns the rules the day still breaks, which only the pins themselves can cause.
+static vector<string> edit_planned_day(const DayTemplateLibrary& library, vector<RoutineEntry>& entries,
+                                       const vector<int>& banned, const vector<RoutineEntry>& pins) {
+    entries.erase(remove_if(entries.begin(), entries.end(), [&](const RoutineEntry& e) {
+        if (find(banned.begin(), banned.end(), exercise_index(library, e.exercise)) != banned.end()) return true;
+        return any_of(pins.begin(), pins.end(), [&](const RoutineEntry& pin) { return pin.exercise == e.exercise; });
+    }), entries.end());
+    size_t unpinned = entries.size();
+    entries.insert(entries.end(), pins.begin(), pins.end());
+
+    auto is_leg = [&](const RoutineEntry& entry) {
+        int e = exercise_index(library, entry.exercise);
+        return e >= 0 && library.is_leg[e];
+    };
+    auto day_time = [&]() {
+        double time = 0.0;
+        for (const auto& entry : entries) time += entry.sets * TIME_PER_SET;
+        return time;
+    };
+    int leg_exercises = count_if(entries.begin(), entries.end(), is_leg);
+    for (size_t i = unpinned; i-- > 0 && leg_exercises > 2;) {
+        if (!is_leg(entries[i])) continue;
+        entries.erase(entries.begin() + i);
+        unpinned--;
+        leg_exercises--;
+    }
+    while (unpinned > 0 && (entries.size() > MAX_EXERCISES_PER_DAY || day_time() > MAX_TIME_PER_DAY)) {
+        entries.erase(entries.begin() + --unpinned);
+    }
+    return day_violations(library, entries);
+}
+
+// Function to re-optimize the days that are still open. Frozen and skipped days are fixed
+// contributions to the weekly totals; every open day picks a template that keeps its pinned
+// entries and avoids removed exercises, trading the routine cost against divergence from the
+// original day. Best-response passes over the open days run until no day changes, which is
+// deterministic and takes a few milliseconds on the default catalog. When no template fits a
+// day the planned day is edited instead; if that day still breaks the day rules, the pins
+// cannot be honoured and an empty routine is returned.
+vector<vector<RoutineEntry>> replan_routine(const DayTemplateLibrary& library,
+                                            const vector<vector<RoutineEntry>>& routine,
+                                            const ReplanConstraints& constraints,
+                                            double divergence_penalty) {
+    vector<vector<RoutineEntry>> result = routine;
+    result.resize(TOTAL_DAYS);
+    vector<bool> fixed(TOTAL_DAYS, false);
+    for (int day : constraints.frozen_days) {
+        if (day >= 0 && day < TOTAL_DAYS) fixed[day] = true;
+    }
+    for (int day : constraints.skipped_days) {
+        if (day < 0 || day >= TOTAL_DAYS) continue;
+        fixed[day] = true;
+        result[day].clear();
+    }
+
+    // Templates allowed on each open day
+    vector<vector<size_t>> allowed(TOTAL_DAYS);
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        if (fixed[day]) continue;
+        vector<int> banned;
+        vector<pair<int, int>> required;
+        vector<RoutineEntry> pins;
+        for (const auto& [d, name] : constraints.removed) {
+            if (d == day || d == -1) banned.push_back(exercise_index(library, name));
+        }
+        for (const auto& [d, entry] : constraints.pinned) {
+            if (d != day) continue;
+            required.push_back({exercise_index(library, entry.exercise), entry.sets});
+            pins.push_back(entry);
+        }
+        for (size_t t = 0; t < library.size(); ++t) {
+            const uint16_t* first = &library.entry_exercise[library.offset[t]];
+            const uint16_t* last = &library.entry_exercise[library.offset[t + 1]];
+            bool ok = none_of(first, last, [&](uint16_t e) { return find(banned.begin(), banned.end(), e) != banned.end(); });
+            for (size_t r = 0; ok && r < required.size(); ++r) {
+                const uint16_t* hit = find(first, last, required[r].first);
+                ok = hit != last && library.entry_sets[hit - library.entry_exercise.data()] == required[r].second;
+            }
+            if (ok) allowed[day].push_back(t);
+        }
+        if (allowed[day].empty()) {
+            // No feasible day honours the request; apply it to the planned day as given
+            optimizer_log() << "No day template fits the changes on day " << day + 1 << "; editing the planned day" << endl;
+            vector<string> violations = edit_planned_day(library, result[day], banned, pins);
+            if (!violations.empty()) {
+                cerr << "Error: the changes on day " << day + 1 << " cannot be honoured:";
+                for (const auto& violation : violations) cerr << " " << violation << ";";
+                cerr << endl;
+                return {};
+            }
+            fixed[day] = true;
+        }
+    }
+
+    // Skipped days are not trained, so they stay out of the time balance
+    TemplateWeek week = make_template_week(library);
+    for (int day : constraints.skipped_days) {
+        if (day >= 0 && day < TOTAL_DAYS) week.skipped[day] = true;
+    }
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        if (fixed[day]) apply_entries(library, week, day, result[day], 1);
+    }
+
+    // Divergence of every allowed template, then start each open day from the closest one
+    vector<vector<double>> allowed_divergence(TOTAL_DAYS);
+    vector<size_t> current_choice(TOTAL_DAYS, 0);
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        if (fixed[day]) continue;
+        for (size_t t : allowed[day]) {
+            allowed_divergence[day].push_back(divergence_penalty * divergence(library, t, routine[day]));
+        }
+        current_choice[day] = min_element(allowed_divergence[day].begin(), allowed_divergence[day].end()) - allowed_divergence[day].begin();
+        week.days[day] = allowed[day][current_choice[day]];
+        apply_template(library, week, day, week.days[day], 1);
+    }
+
+    auto total_divergence = [&]() {
+        double total = 0.0;
+        for (int day = 0; day < TOTAL_DAYS; ++day) {
+            if (!fixed[day]) total += allowed_divergence[day][current_choice[day]];
+        }
+        return total;
+    };
+    double current = week_cost(library, week) + total_divergence();
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        for (int day = 0; day < TOTAL_DAYS; ++day) {
+            if (fixed[day]) continue;
+            size_t best = current_choice[day];
+            double others = total_divergence() - allowed_divergence[day][best];
+            for (size_t i = 0; i < allowed[day].size(); ++i) {
+                set_day(library, week, day, allowed[day][i]);
+                double cost = week_cost(library, week) + others + allowed_divergence[day][i];
+                if (cost < current) {
+                    current = cost;
+                    best = i;
+                    improved = true;
+                }
+            }
+            current_choice[day] = best;
+            set_day(library, week, day, allowed[day][best]);
+        }
+    }
+
+    for (int day = 0; day < TOTAL_DAYS; ++day) {
+        if (!fixed[day]) result[day] = template_day(library, week.days[day]);
+    }
+    return result;
+}
@@ -0,0 +1,25 @@
+#ifndef REPLAN_H
+#define REPLAN_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include "day_templates.h"
+
+// Cost per entry a re-plan adds, drops or changes relative to the original plan
+const double DIVERGENCE_PENALTY = 20000.0;
+
+// Struct to describe what changed since the plan was made
+struct ReplanConstraints {
+    vector<int> frozen_days;                   // days kept exactly as planned (e.g. already done)
+    vector<int> skipped_days;                  // days the member will miss; left empty
+    vector<pair<int, RoutineEntry>> pinned;    // entries that must appear on their day
+    vector<pair<int, string>> removed;         // exercises that must not appear on a day (-1 for every day)
+};
+
+vector<vector<RoutineEntry>> replan_routine(const DayTemplateLibrary& library,
+                                            const vector<vector<RoutineEntry>>& routine,
+                                            const ReplanConstraints& constraints,
+                                            double divergence_penalty = DIVERGENCE_PENALTY);
+
+#endif // REPLAN_H
@@ -0,0 +1,430 @@
+#include "rl_env.h"
+#include "exercise_definitions.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace {
+
+// Environment parameters from WorkoutRoutineEnv.__init__
+const int MAX_STEPS_PER_EPISODE = 50;
+const double TARGET_EXERCISES_PER_DAY = 4.5;
+const int NUM_SETS_OPTIONS = MAX_SETS - MIN_SETS + 1;
+const double REWARD_CLIP = 1e5;
+
+// Observation order of the optimized muscle groups (mav_targets key order in routineRL.py)
+const vector<string> rl_muscle_groups = {
+    "Chest", "Triceps", "Long Head", "Front Delts", "Lateral Delts", "Rear Delts", "Lats",
+    "Mid Traps", "Upper Traps", "Lower Traps", "Biceps", "Quads", "Rectus Femoris",
+    "Hamstrings", "Short Head"
+};
+
+// Recovery table as keyed in routineRL.py. The keys carry exercise suffixes while the
+// catalog lists base muscle names, so lookups only succeed for exact key matches.
+const unordered_map<string, int> rl_recovery_days = {
+    {"Chest (Incline Bench Press)", 2}, {"Chest (Chest Fly)", 2},
+    {"Front Delts (Incline Bench Press)", 1}, {"Front Delts (Chest Fly)", 1},
+    {"Front Delts (Front Raise)", 1}, {"Lats (Pulldown)", 2}, {"Lats (Upper Back Rows)", 1},
+    {"Lats (Lat Prayer)", 2}, {"Mid Traps (Upper Back Rows)", 2}, {"Mid Traps (Kelso Shrugs)", 2},
+    {"Lower Traps (Pulldown)", 1}, {"Lower Traps (Upper Back Rows)", 2}, {"Upper Traps (Shrugs)", 2},
+    {"Upper Traps (Stiff-Legged Deadlift)", 1}, {"Rear Delts (Upper Back Rows)", 2},
+    {"Rear Delts (Pulldown)", 1}, {"Rear Delts (Rear Delts)", 1}, {"Lateral Delts (Lateral Raise)", 1},
+    {"Triceps (Incline Bench Press)", 2}, {"Triceps (Triceps Extension)", 1},
+    {"Long Head (Triceps Extension)", 1}, {"Long Head (Lat Prayer)", 2}, {"Biceps (Pulldown)", 2},
+    {"Biceps (Upper Back Rows)", 1}, {"Biceps (Cable Curl)", 1}, {"Biceps (Front Raise)", 1},
+    {"Quads (Squat)", 3}, {"Quads (Leg Extension)", 2}, {"Rectus Femoris (Leg Extension)", 2},
+    {"Hamstrings (Squat)", 2}, {"Hamstrings (Stiff-Legged Deadlift)", 3},
+    {"Hamstrings (Leg Curl)", 2}, {"Short Head (Leg Curl)", 2}
+};
+
+// Per-exercise lookup tables shared by every environment in a batch
+struct RLCatalog {
+    int num_exercises;
+    int num_muscles;                          // optimized groups first, then the rest
+    vector<vector<double>> contribution;      // [exercise][muscle] volume per set
+    vector<vector<int>> worked_muscles;       // [exercise] muscles in primary+secondary+isometric order
+    vector<int> recovery_days;                // [muscle], 0 when the muscle has no recovery entry
+    vector<double> targets;                   // [group] mav_targets target of each optimized group
+    vector<double> upper_bounds;              // [group]
+    vector<bool> is_compound;
+    vector<bool> is_leg;
+    vector<bool> once_per_week;
+};
+
+RLCatalog build_catalog() {
+    RLCatalog catalog;
+    catalog.num_exercises = exercises.size();
+    vector<string> muscle_names = rl_muscle_groups;
+    auto muscle_index = [&](const string& muscle) {
+        auto it = find(muscle_names.begin(), muscle_names.end(), muscle);
+        if (it != muscle_names.end()) return int(it - muscle_names.begin());
+        muscle_names.push_back(muscle);
+        return int(muscle_names.size()) - 1;
+    };
+    for (const auto& ex : exercises) {
+        vector<int> worked;
+        for (const auto& m : ex.primary) worked.push_back(muscle_index(m));
+        for (const auto& m : ex.secondary) worked.push_back(muscle_index(m));
+        for (const auto& m : ex.isometric) worked.push_back(muscle_index(m));
+        catalog.worked_muscles.push_back(worked);
+        catalog.is_compound.push_back(ex.is_compound);
+        catalog.is_leg.push_back(ex.is_leg);
+        catalog.once_per_week.push_back(ex.name == "Squat" || ex.name == "Stiff-Legged Deadlift");
+    }
+    catalog.num_muscles = muscle_names.size();
+    for (const auto& ex : exercises) {
+        vector<double> contribution(catalog.num_muscles, 0.0);
+        for (const auto& m : ex.primary) contribution[muscle_index(m)] += 1.0;
+        for (const auto& m : ex.secondary) contribution[muscle_index(m)] += 0.5;
+        for (const auto& m : ex.isometric) contribution[muscle_index(m)] += 0.25;
+        catalog.contribution.push_back(contribution);
+    }
+    for (const auto& name : muscle_names) {
+        auto it = rl_recovery_days.find(name);
+        catalog.recovery_days.push_back(it != rl_recovery_days.end() ? it->second : 0);
+    }
+    for (const auto& name : rl_muscle_groups) {
+        const MuscleGroup& group = mav_targets.at(name);
+        catalog.targets.push_back(group.target);
+        catalog.upper_bounds.push_back(group.upper_bound);
+    }
+    return catalog;
+}
+
+const RLCatalog& rl_catalog() {
+    static const RLCatalog catalog = build_catalog();
+    return catalog;
+}
+
+double clip_reward(double reward) {
+    return min(max(reward, -REWARD_CLIP), REWARD_CLIP);
+}
+
+double exercise_count_reward(int num_exercises) {
+    double reward;
+    if (num_exercises < MIN_EXERCISES_PER_DAY) {
+        reward = -200.0 * (MIN_EXERCISES_PER_DAY - num_exercises);
+    } else if (num_exercises > MAX_EXERCISES_PER_DAY) {
+        reward = -500.0 * (num_exercises - MAX_EXERCISES_PER_DAY);
+    } else {
+        reward = 100.0 * num_exercises;
+    }
+    return clip_reward(reward);
+}
+
+double time_equivalence_reward(const RLEnvBatch& batch, int env) {
+    const double* day_times = &batch.day_times[env * TOTAL_DAYS];
+    const int* day_counts = &batch.day_counts[env * TOTAL_DAYS];
+    int days = min(batch.current_day[env], TOTAL_DAYS);
+    if (days <= 0) return 0.0;
+    double total_time = 0.0;
+    double total_exercises = 0.0;
+    for (int d = 0; d < days; ++d) {
+        total_time += day_times[d];
+        total_exercises += day_counts[d];
+    }
+    double current_time = day_times[min(batch.current_day[env] - 1, TOTAL_DAYS - 1)];
+    double reward = -abs(current_time - TARGET_AVG_TIME) * 40.0;
+    reward -= abs(total_time / days - TARGET_AVG_TIME) * 80.0;
+    if (current_time == 0) {
+        reward += -2000.0 - batch.empty_days[env] * 500.0;
+    }
+    reward -= abs(total_exercises / days - TARGET_EXERCISES_PER_DAY) * 100.0;
+    return clip_reward(reward);
+}
+
+// Scores the volume change since prev_volume; deficits is scratch space for one env's groups
+double volume_reward(const RLEnvBatch& batch, int env, const double* prev_volume, double* deficits) {
+    const RLCatalog& catalog = rl_catalog();
+    const double* volume = &batch.volume[env * catalog.num_muscles];
+    int num_groups = rl_muscle_groups.size();
+    double max_deficit = 0.0;
+    for (int m = 0; m < num_groups; ++m) {
+        double target = catalog.targets[m];
+        deficits[m] = min(max(0.0, target - volume[m]) / target, 2.0);
+        max_deficit = max(max_deficit, deficits[m]);
+    }
+    if (max_deficit == 0) max_deficit = 1.0;
+
+    double reward = 0.0;
+    for (int m = 0; m < num_groups; ++m) {
+        double delta = volume[m] - prev_volume[m];
+        if (delta <= 0) continue;
+        double deficit = deficits[m] / max_deficit;
+        double excess = max(0.0, volume[m] - catalog.upper_bounds[m]);
+        if (deficit > 0) {
+            reward += delta * 300 * (1 + deficit);
+        } else if (excess > 0) {
+            reward -= excess * 150;
+        } else {
+            reward += delta * 100;
+        }
+        if (deficit > 0.5) {
+            reward += 500.0 * delta;
+        }
+    }
+    return clip_reward(reward);
+}
+
+// Adds the end-of-week terms to reward in the same order as routineRL.py
+double final_reward(const RLEnvBatch& batch, int env, double reward) {
+    const RLCatalog& catalog = rl_catalog();
+    const double* volume = &batch.volume[env * catalog.num_muscles];
+    for (size_t m = 0; m < rl_muscle_groups.size(); ++m) {
+        double deficit = min(max(0.0, catalog.targets[m] - volume[m]) / catalog.targets[m], 2.0);
+        double excess = max(0.0, volume[m] - catalog.upper_bounds[m]);
+        if (deficit > 0) {
+            reward -= deficit * 300 * (1 + deficit);
+        } else if (excess > 0) {
+            reward -= excess * 150;
+        } else {
+            reward += (volume[m] - catalog.targets[m]) * 100;
+        }
+    }
+    int unused = 0;
+    for (int e = 0; e < catalog.num_exercises; ++e) {
+        if (batch.exercise_usage[env * catalog.num_exercises + e] == 0) ++unused;
+    }
+    reward -= unused * 500;
+    reward += (catalog.num_exercises - unused) * 1000;
+    reward -= batch.empty_days[env] * 1000;
+    return reward;
+}
+
+bool can_work_muscle(const RLEnvBatch& batch, int env, int muscle, int day) {
+    const RLCatalog& catalog = rl_catalog();
+    int required_gap = catalog.recovery_days[muscle];
+    if (required_gap == 0) return true;
+    return day - batch.last_worked_day[env * catalog.num_muscles + muscle] >= required_gap;
+}
+
+// Applies a skip-day action; returns the reward and sets done after the last day
+double skip_day(RLEnvBatch& batch, int env, bool& done) {
+    const RLCatalog& catalog = rl_catalog();
+    double reward = exercise_count_reward(batch.day_counts[env * TOTAL_DAYS + batch.current_day[env] - 1]);
+    batch.current_day[env] += 1;
+    if (batch.current_day[env] > TOTAL_DAYS) {
+        done = true;
+        return clip_reward(final_reward(batch, env, reward));
+    }
+    reward += time_equivalence_reward(batch, env);
+    if (batch.day_counts[env * TOTAL_DAYS + batch.current_day[env] - 1] == 0) {
+        for (int m = 0; m < catalog.num_muscles; ++m) {
+            if (batch.recovery_timers[env * catalog.num_muscles + m] > 0) reward += 50.0;
+        }
+    }
+    return reward;
+}
+
+// Applies an (exercise, sets) action with the soft constraint penalties of routineRL.py
+double add_exercise(RLEnvBatch& batch, int env, int action) {
+    const RLCatalog& catalog = rl_catalog();
+    int exercise = action / NUM_SETS_OPTIONS;
+    int sets = MIN_SETS + action % NUM_SETS_OPTIONS;
+    int day = batch.current_day[env] - 1;
+    int count = batch.day_counts[env * TOTAL_DAYS + day];
+    const int* slots = &batch.day_exercises[(env * TOTAL_DAYS + day) * MAX_EXERCISES_PER_DAY];
+    double factor = batch.recovery_penalty_factor[env];
+    double reward = 0.0;
+    bool valid = true;
+
+    double time_for_exercise = sets * TIME_PER_SET;
+    if (batch.day_times[env * TOTAL_DAYS + day] + time_for_exercise > MAX_TIME_PER_DAY) {
+        valid = false;
+        reward -= 100.0;
+    }
+    if (count >= MAX_EXERCISES_PER_DAY) {
+        valid = false;
+        reward -= 1000.0;
+    }
+    if (find(slots, slots + count, exercise) != slots + count) {
+        valid = false;
+        reward -= 100.0;
+    }
+    int leg_count = count_if(slots, slots + count, [&](int e) { return catalog.is_leg[e]; });
+    if (catalog.is_leg[exercise] && leg_count >= 1) {
+        valid = false;
+        reward -= 100.0;
+    }
+    for (int m : catalog.worked_muscles[exercise]) {
+        if (!can_work_muscle(batch, env, m, batch.current_day[env])) {
+            valid = false;
+            reward -= 10.0 * factor;
+            break;
+        }
+    }
+    if (catalog.once_per_week[exercise]) {
+        // Stops at the first other day once the action is invalid, as the Python loop does
+        for (int d = 0; d < TOTAL_DAYS; ++d) {
+            if (d == day) continue;
+            const int* other = &batch.day_exercises[(env * TOTAL_DAYS + d) * MAX_EXERCISES_PER_DAY];
+            int other_count = batch.day_counts[env * TOTAL_DAYS + d];
+            if (find(other, other + other_count, exercise) != other + other_count) {
+                valid = false;
+                reward -= 100.0;
+            }
+            if (!valid) break;
+        }
+    }
+    if (count == 0 && !catalog.is_compound[exercise]) {
+        valid = false;
+        reward -= factor < 1.0 ? 1000.0 : 100.0;
+    }
+    if (!valid) return reward;
+
+    int slot = (env * TOTAL_DAYS + day) * MAX_EXERCISES_PER_DAY + count;
+    batch.day_exercises[slot] = exercise;
+    batch.day_sets[slot] = sets;
+    batch.day_counts[env * TOTAL_DAYS + day] += 1;
+    batch.day_times[env * TOTAL_DAYS + day] += time_for_exercise;
+    batch.total_exercises_added[env] += 1;
+
+    int usage_index = env * catalog.num_exercises + exercise;
+    bool was_unused = batch.exercise_usage[usage_index] == 0;
+    // Infinite on first use because last_used_day starts at -inf, matching routineRL.py
+    double days_since_last_use = batch.current_day[env] - batch.last_used_day[usage_index] - 1;
+    batch.exercise_usage[usage_index] += 1;
+    batch.last_used_day[usage_index] = batch.current_day[env];
+    for (int m : catalog.worked_muscles[exercise]) {
+        if (catalog.recovery_days[m] > 0) {
+            batch.last_worked_day[env * catalog.num_muscles + m] = batch.current_day[env];
+            batch.recovery_timers[env * catalog.num_muscles + m] = catalog.recovery_days[m];
+        }
+    }
+
+    double* volume = &batch.volume[env * catalog.num_muscles];
+    double* prev_volume = &batch.prev_volume[env * catalog.num_muscles];
+    copy(volume, volume + catalog.num_muscles, prev_volume);
+    for (int m = 0; m < catalog.num_muscles; ++m) {
+        volume[m] += sets * catalog.contribution[exercise][m];
+    }
+    reward += volume_reward(batch, env, prev_volume, &batch.deficits[env * rl_muscle_groups.size()]);
+    reward += time_equivalence_reward(batch, env);
+    reward += exercise_count_reward(batch.day_counts[env * TOTAL_DAYS + day]);
+    if (was_unused) reward += 2000.0;
+    reward += days_since_last_use * 50.0;
+    reward += 50.0;
+    return reward;
+}
+
+} // namespace
+
+int rl_observation_size() {
+    return 3 + 2 * rl_muscle_groups.size() + rl_catalog().num_exercises;
+}
+
+int rl_action_count() {
+    return rl_catalog().num_exercises * NUM_SETS_OPTIONS + 1;
+}
+
+bool rl_action_valid(int action) {
+    return action >= 0 && action < rl_action_count();
+}
+
+RLEnvBatch make_env_batch(int num_envs) {
+    const RLCatalog& catalog = rl_catalog();
+    RLEnvBatch batch;
+    batch.num_envs = num_envs;
+    batch.current_day.resize(num_envs);
+    batch.step_count.resize(num_envs);
+    batch.empty_days.resize(num_envs);
+    batch.total_exercises_added.resize(num_envs);
+    batch.recovery_penalty_factor.resize(num_envs);
+    batch.day_times.resize(num_envs * TOTAL_DAYS);
+    batch.day_counts.resize(num_envs * TOTAL_DAYS);
+    batch.day_exercises.resize(num_envs * TOTAL_DAYS * MAX_EXERCISES_PER_DAY);
+    batch.day_sets.resize(num_envs * TOTAL_DAYS * MAX_EXERCISES_PER_DAY);
+    batch.volume.resize(num_envs * catalog.num_muscles);
+    batch.exercise_usage.resize(num_envs * catalog.num_exercises);
+    batch.last_used_day.resize(num_envs * catalog.num_exercises);
+    batch.last_worked_day.resize(num_envs * catalog.num_muscles);
+    batch.recovery_timers.resize(num_envs * catalog.num_muscles);
+    batch.prev_volume.resize(num_envs * catalog.num_muscles);
+    batch.deficits.resize(num_envs * rl_muscle_groups.size());
+    for (int env = 0; env < num_envs; ++env) {
+        reset_env(batch, env);
+    }
+    return batch;
+}
+
+void reset_env(RLEnvBatch& batch, int env) {
+    const RLCatalog& catalog = rl_catalog();
+    const double never = -numeric_limits<double>::infinity();
+    batch.current_day[env] = 1;
+    batch.step_count[env] = 0;
+    batch.empty_days[env] = 0;
+    batch.total_exercises_added[env] = 0;
+    batch.recovery_penalty_factor[env] = 0.0;
+    fill_n(&batch.day_times[env * TOTAL_DAYS], TOTAL_DAYS, 0.0);
+    fill_n(&batch.day_counts[env * TOTAL_DAYS], TOTAL_DAYS, 0);
+    fill_n(&batch.volume[env * catalog.num_muscles], catalog.num_muscles, 0.0);
+    fill_n(&batch.exercise_usage[env * catalog.num_exercises], catalog.num_exercises, 0);
+    fill_n(&batch.last_used_day[env * catalog.num_exercises], catalog.num_exercises, never);
+    fill_n(&batch.last_worked_day[env * catalog.num_muscles], catalog.num_muscles, never);
+    fill_n(&batch.recovery_timers[env * catalog.num_muscles], catalog.num_muscles, 0);
+}
+
+void write_observation(const RLEnvBatch& batch, int env, float* observation) {
+    const RLCatalog& catalog = rl_catalog();
+    int size = rl_observation_size();
+    int day = batch.current_day[env];
+    if (day > TOTAL_DAYS) {
+        fill_n(observation, size, 0.0f);
+        return;
+    }
+    int i = 0;
+    observation[i++] = day;
+    observation[i++] = batch.day_times[env * TOTAL_DAYS + day - 1];
+    observation[i++] = batch.day_counts[env * TOTAL_DAYS + day - 1];
+    for (size_t m = 0; m < rl_muscle_groups.size(); ++m) {
+        observation[i++] = batch.volume[env * catalog.num_muscles + m];
+    }
+    for (int e = 0; e < catalog.num_exercises; ++e) {
+        observation[i++] = batch.exercise_usage[env * catalog.num_exercises + e] > 0 ? 1.0f : 0.0f;
+    }
+    for (size_t m = 0; m < rl_muscle_groups.size(); ++m) {
+        observation[i++] = max(0, batch.recovery_timers[env * catalog.num_muscles + m]);
+    }
+}
+
+double step_env(RLEnvBatch& batch, int env, int action, bool& done) {
+    const RLCatalog& catalog = rl_catalog();
+    done = false;
+    // Stepping a finished episode is an error in the Python env; here it is a terminal no-op
+    if (batch.current_day[env] > TOTAL_DAYS) {
+        done = true;
+        return 0.0;
+    }
+    batch.step_count[env] += 1;
+    if (batch.step_count[env] > MAX_STEPS_PER_EPISODE) {
+        done = true;
+        return -1000.0;
+    }
+    if (batch.day_counts[env * TOTAL_DAYS + batch.current_day[env] - 1] == 0) {
+        batch.empty_days[env] += 1;
+    }
+    for (int m = 0; m < catalog.num_muscles; ++m) {
+        int& timer = batch.recovery_timers[env * catalog.num_muscles + m];
+        timer = max(0, timer - 1);
+    }
+    if (action == catalog.num_exercises * NUM_SETS_OPTIONS) {
+        return skip_day(batch, env, done);
+    }
+    return add_exercise(batch, env, action);
+}
+
+bool step_env_batch(RLEnvBatch& batch, const int* actions, float* observations, double* rewards, unsigned char* dones) {
+    for (int env = 0; env < batch.num_envs; ++env) {
+        if (!rl_action_valid(actions[env])) return false;
+    }
+    int size = rl_observation_size();
+    for (int env = 0; env < batch.num_envs; ++env) {
+        bool done;
+        rewards[env] = step_env(batch, env, actions[env], done);
+        dones[env] = done;
+        write_observation(batch, env, observations + env * size);
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef RL_ENV_H
+#define RL_ENV_H
+
+#include <vector>
+
+// Batched port of WorkoutRoutineEnv from routineRL.py. N environments are stored as
+// struct-of-arrays (env-major, contiguous) and stepped in lockstep; state, action and
+// reward semantics match the Python environment step for step.
+struct RLEnvBatch {
+    int num_envs;
+    std::vector<int> current_day;             // [env], 1-based like the Python env
+    std::vector<int> step_count;              // [env]
+    std::vector<int> empty_days;              // [env]
+    std::vector<int> total_exercises_added;   // [env]
+    std::vector<double> recovery_penalty_factor;  // [env]
+    std::vector<double> day_times;            // [env][day]
+    std::vector<int> day_counts;              // [env][day]
+    std::vector<int> day_exercises;           // [env][day][slot] exercise index
+    std::vector<int> day_sets;                // [env][day][slot]
+    std::vector<double> volume;               // [env][muscle] over the optimized muscle groups
+    std::vector<int> exercise_usage;          // [env][exercise]
+    std::vector<double> last_used_day;        // [env][exercise], -inf until first use
+    std::vector<double> last_worked_day;      // [env][muscle], -inf until worked
+    std::vector<int> recovery_timers;         // [env][muscle]
+    std::vector<double> prev_volume;          // [env][muscle] scratch: volume before the current step
+    std::vector<double> deficits;             // [env][group] scratch for the volume reward
+};
+
+int rl_observation_size();
+int rl_action_count();
+bool rl_action_valid(int action);
+RLEnvBatch make_env_batch(int num_envs);
+void reset_env(RLEnvBatch& batch, int env);
+void write_observation(const RLEnvBatch& batch, int env, float* observation);
+// step_env expects rl_action_valid(action); step_env_batch checks every action first and
+// returns false without stepping any environment when one is out of range
+double step_env(RLEnvBatch& batch, int env, int action, bool& done);
+bool step_env_batch(RLEnvBatch& batch, const int* actions, float* observations, double* rewards, unsigned char* dones);
+
+#endif // RL_ENV_H
@@ -0,0 +1,41 @@
+#include "rl_env_c.h"
+#include "rl_env.h"
+#include <algorithm>
+
+struct WorkoutEnvBatch {
+    RLEnvBatch envs;
+};
+
+int workout_env_observation_size(void) {
+    return rl_observation_size();
+}
+
+int workout_env_action_count(void) {
+    return rl_action_count();
+}
+
+WorkoutEnvBatch* workout_env_create(int num_envs) {
+    if (num_envs <= 0) return nullptr;
+    return new WorkoutEnvBatch{make_env_batch(num_envs)};
+}
+
+void workout_env_destroy(WorkoutEnvBatch* batch) {
+    delete batch;
+}
+
+void workout_env_reset(WorkoutEnvBatch* batch, int env, float* observations) {
+    int size = rl_observation_size();
+    for (int i = 0; i < batch->envs.num_envs; ++i) {
+        if (env >= 0 && i != env) continue;
+        reset_env(batch->envs, i);
+        if (observations) write_observation(batch->envs, i, observations + i * size);
+    }
+}
+
+int workout_env_step(WorkoutEnvBatch* batch, const int* actions, float* observations, double* rewards, unsigned char* dones) {
+    return step_env_batch(batch->envs, actions, observations, rewards, dones) ? 0 : -1;
+}
+
+void workout_env_set_recovery_penalty_factor(WorkoutEnvBatch* batch, double factor) {
+    std::fill(batch->envs.recovery_penalty_factor.begin(), batch->envs.recovery_penalty_factor.end(), factor);
+}
@@ -0,0 +1,28 @@
+#ifndef RL_ENV_C_H
+#define RL_ENV_C_H
+
+// C ABI over RLEnvBatch for loading from Python with ctypes. Observations are
+// float32 [num_envs][observation_size], rewards float64 and dones uint8 per env.
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct WorkoutEnvBatch WorkoutEnvBatch;
+
+int workout_env_observation_size(void);
+int workout_env_action_count(void);
+WorkoutEnvBatch* workout_env_create(int num_envs);
+void workout_env_destroy(WorkoutEnvBatch* batch);
+// Resets every environment (env < 0) or a single one, writing into the matching
+// observation rows when observations is not NULL
+void workout_env_reset(WorkoutEnvBatch* batch, int env, float* observations);
+// Steps every environment; returns 0, or -1 without stepping any when an action lies
+// outside [0, action_count)
+int workout_env_step(WorkoutEnvBatch* batch, const int* actions, float* observations, double* rewards, unsigned char* dones);
+void workout_env_set_recovery_penalty_factor(WorkoutEnvBatch* batch, double factor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RL_ENV_C_H
@@ -0,0 +1,73 @@
+import ctypes
+import os
+
+import numpy as np
+
+# Batched WorkoutRoutineEnv backed by rl_env.cpp. Build the library with:
+#   g++ -std=c++17 -O2 -shared -fPIC rl_env.cpp rl_env_c.cpp -o libworkout_env.so
+
+
+class NativeWorkoutRoutineEnvs:
+    def __init__(self, num_envs, library_path=None):
+        if library_path is None:
+            library_path = os.path.join(
+                os.path.dirname(os.path.abspath(__file__)), "libworkout_env.so"
+            )
+        self.lib = ctypes.CDLL(library_path)
+        self.lib.workout_env_create.restype = ctypes.c_void_p
+        self.lib.workout_env_create.argtypes = [ctypes.c_int]
+        self.lib.workout_env_destroy.argtypes = [ctypes.c_void_p]
+        self.lib.workout_env_reset.argtypes = [
+            ctypes.c_void_p,
+            ctypes.c_int,
+            ctypes.c_void_p,
+        ]
+        self.lib.workout_env_step.restype = ctypes.c_int
+        self.lib.workout_env_step.argtypes = [ctypes.c_void_p] * 5
+        self.lib.workout_env_set_recovery_penalty_factor.argtypes = [
+            ctypes.c_void_p,
+            ctypes.c_double,
+        ]
+
+        self.num_envs = num_envs
+        self.observation_size = self.lib.workout_env_observation_size()
+        self.action_count = self.lib.workout_env_action_count()
+        self.handle = self.lib.workout_env_create(num_envs)
+        if not self.handle:
+            raise ValueError("num_envs must be positive")
+
+        # Buffers are reused across steps; copy them if they must outlive the next call
+        self.states = np.zeros((num_envs, self.observation_size), dtype=np.float32)
+        self.rewards = np.zeros(num_envs, dtype=np.float64)
+        self.dones = np.zeros(num_envs, dtype=np.uint8)
+        self.actions = np.zeros(num_envs, dtype=np.int32)
+
+    def reset(self, env=-1):
+        self.lib.workout_env_reset(self.handle, env, self.states.ctypes.data)
+        return self.states if env < 0 else self.states[env]
+
+    def step(self, actions):
+        self.actions[:] = actions
+        status = self.lib.workout_env_step(
+            self.handle,
+            self.actions.ctypes.data,
+            self.states.ctypes.data,
+            self.rewards.ctypes.data,
+            self.dones.ctypes.data,
+        )
+        if status != 0:
+            raise ValueError(
+                f"actions must lie in [0, {self.action_count}), got {self.actions}"
+            )
+        return self.states, self.rewards, self.dones.astype(bool)
+
+    def set_recovery_penalty_factor(self, factor):
+        self.lib.workout_env_set_recovery_penalty_factor(self.handle, factor)
+
+    def close(self):
+        if self.handle:
+            self.lib.workout_env_destroy(self.handle)
+            self.handle = None
+
+    def __del__(self):
+        self.close()
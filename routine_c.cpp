@@ -0,0 +1,269 @@
+#include "routine_c.h"
+#include "optimizer.h"
+#include "day_templates.h"
+#include "genetic.h"
+#include "profile.h"
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <exception>
+#include <iostream>
+
+struct WorkoutRoutineContext {
+    std::mutex lock;
+    UserProfile profile = default_profile("");
+    CostWeights weights;                          // Built-in weights, unless set on this context
+    std::vector<Exercise> catalog = exercises;
+    std::unique_ptr<DayTemplateLibrary> library;  // Built on first template run for the profile
+    std::vector<std::vector<RoutineEntry>> routine;
+    std::vector<WorkoutRoutineEntry> entries;
+    double cost = 0.0;
+    int violations = 0;
+    std::string error;
+    WorkoutProgressCallback progress_callback = nullptr;
+    void* progress_user_data = nullptr;
+    double progress_min_seconds = 0.05;
+    WorkoutLogCallback log_callback = nullptr;
+    void* log_user_data = nullptr;
+    bool quiet = false;
+};
+
+// Stream buffer that hands the engines' log to a context's callback one line at a time
+struct LogLineSink : std::streambuf {
+    WorkoutLogCallback callback;
+    void* user_data;
+    std::string line;
+
+    LogLineSink(WorkoutLogCallback callback, void* user_data) : callback(callback), user_data(user_data) {}
+    ~LogLineSink() override {
+        if (!line.empty()) callback(line.c_str(), user_data);
+    }
+    int overflow(int c) override {
+        if (c == traits_type::eof()) return traits_type::not_eof(c);
+        if (c == '\n') {
+            callback(line.c_str(), user_data);
+            line.clear();
+        } else {
+            line.push_back(static_cast<char>(c));
+        }
+        return c;
+    }
+};
+
+// Struct to point the calling thread's engine log at a stream for one optimize call
+struct ScopedOptimizerLog {
+    std::ostream* previous;
+    explicit ScopedOptimizerLog(std::ostream* log) : previous(set_optimizer_log(log)) {}
+    ~ScopedOptimizerLog() { set_optimizer_log(previous); }
+};
+
+// Function to flatten a routine into C entries pointing at its exercise names
+static std::vector<WorkoutRoutineEntry> flatten_routine(const std::vector<std::vector<RoutineEntry>>& routine) {
+    std::vector<WorkoutRoutineEntry> entries;
+    for (size_t day = 0; day < routine.size(); ++day) {
+        for (const auto& entry : routine[day]) {
+            entries.push_back({static_cast<int>(day), entry.exercise.c_str(), entry.sets});
+        }
+    }
+    return entries;
+}
+
+// Function to record a failed call's error; stays silent if even that fails, since nothing may
+// unwind into the host
+static void record_error(WorkoutRoutineContext* context, const char* message) noexcept {
+    try {
+        std::lock_guard<std::mutex> guard(context->lock);
+        context->error = message;
+    } catch (...) {
+    }
+}
+
+// Function to run an entry point's body so that no exception crosses the C ABI: one that escapes
+// is recorded as the context's error and the call returns `failed`
+template <typename T, typename Body>
+static T guarded(WorkoutRoutineContext* context, T failed, Body body) noexcept {
+    try {
+        return body();
+    } catch (const std::exception& e) {
+        record_error(context, e.what());
+    } catch (...) {
+        record_error(context, "unknown error");
+    }
+    return failed;
+}
+
+// Function to switch a context to a new profile, dropping everything built for the old one
+static void use_profile(WorkoutRoutineContext* context, const UserProfile& profile) {
+    context->profile = profile;
+    context->catalog = profile_exercises(profile, exercises);
+    context->library.reset();
+    context->routine.clear();
+    context->entries.clear();
+    context->cost = 0.0;
+    context->violations = 0;
+}
+
+int workout_routine_api_version(void) noexcept {
+    return WORKOUT_ROUTINE_API_VERSION;
+}
+
+WorkoutRoutineContext* workout_routine_create(void) noexcept {
+    try {
+        return new WorkoutRoutineContext();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void workout_routine_destroy(WorkoutRoutineContext* context) noexcept {
+    delete context;
+}
+
+int workout_routine_set_profile(WorkoutRoutineContext* context, const char* text, int format) noexcept {
+    return guarded(context, -1, [&]() {
+        std::lock_guard<std::mutex> guard(context->lock);
+        if (!text || (format != WORKOUT_PROFILE_CSV && format != WORKOUT_PROFILE_JSONL)) {
+            context->error = "invalid profile arguments";
+            return -1;
+        }
+        std::istringstream in(text);
+        ProfileStream stream = open_profile_stream(in, format == WORKOUT_PROFILE_CSV ? ProfileFormat::Csv : ProfileFormat::Jsonl);
+        stream.base_weights = &context->weights;
+        UserProfile profile;
+        if (!next_profile(stream, profile)) {
+            context->error = "no member in profile";
+            return -1;
+        }
+        use_profile(context, profile);
+        context->error.clear();
+        return 0;
+    });
+}
+
+void workout_routine_reset_profile(WorkoutRoutineContext* context) noexcept {
+    guarded(context, 0, [&]() {
+        std::lock_guard<std::mutex> guard(context->lock);
+        use_profile(context, default_profile(""));
+        return 0;
+    });
+}
+
+int workout_routine_optimize(WorkoutRoutineContext* context, int engine, unsigned int seed) noexcept {
+    return guarded(context, -1, [&]() {
+        std::lock_guard<std::mutex> guard(context->lock);
+        const UserProfile& profile = context->profile;
+        // The member's own penalties, else the context's; never the process-wide cost_weights
+        OptimizerProfile member = profile.overrides;
+        if (!member.weights) member.weights = context->weights;
+        const OptimizerProfile* overrides = &member;
+        ProgressObserver observer;
+        ProgressObserver* progress = nullptr;
+        if (context->progress_callback) {
+            observer.min_seconds = context->progress_min_seconds;
+            observer.callback = [context](const ProgressView& view) {
+                std::vector<WorkoutRoutineEntry> entries = flatten_routine(*view.best_routine);
+                WorkoutProgress report{view.iteration, view.best_cost, view.improved, view.final, entries.data(), static_cast<int>(entries.size())};
+                context->progress_callback(&report, context->progress_user_data);
+            };
+            progress = &observer;
+        }
+        LogLineSink sink(context->log_callback, context->log_user_data);
+        std::ostream sink_stream(&sink);
+        ScopedOptimizerLog log(context->quiet ? nullptr : context->log_callback ? &sink_stream : &std::cout);
+        if (engine == WORKOUT_ENGINE_TEMPLATES) {
+            if (!context->library) {
+                context->library.reset(new DayTemplateLibrary(build_day_templates(context->catalog, profile.mav_targets, overrides)));
+            }
+            context->routine = optimize_day_templates(*context->library, seed);
+        } else if (engine == WORKOUT_ENGINE_ANNEALING) {
+            OptimizerTelemetry telemetry;
+            context->routine = optimize_routine(context->catalog, profile.mav_targets, telemetry, seed, overrides, nullptr, progress);
+        } else if (engine == WORKOUT_ENGINE_GENETIC) {
+            GeneticOptions options;
+            options.seed = seed;
+            context->routine = optimize_routine_genetic(context->catalog, profile.mav_targets, options, overrides, progress);
+        } else {
+            context->error = "unknown engine " + std::to_string(engine);
+            return -1;
+        }
+        if (context->routine.empty()) {
+            context->error = "no routine found";
+            return -1;
+        }
+        context->cost = compute_cost(context->routine, profile.mav_targets, context->catalog, overrides);
+        context->violations = static_cast<int>(check_routine(context->routine, context->catalog, overrides).size());
+        context->entries = flatten_routine(context->routine);
+        context->error.clear();
+        return static_cast<int>(context->entries.size());
+    });
+}
+
+int workout_routine_entries(WorkoutRoutineContext* context, WorkoutRoutineEntry* entries, int capacity) noexcept {
+    return guarded(context, -1, [&]() {
+        std::lock_guard<std::mutex> guard(context->lock);
+        int count = static_cast<int>(context->entries.size());
+        for (int i = 0; entries && i < count && i < capacity; ++i) entries[i] = context->entries[i];
+        return count;
+    });
+}
+
+void workout_routine_set_progress_callback(WorkoutRoutineContext* context, WorkoutProgressCallback callback, void* user_data, double min_seconds) noexcept {
+    guarded(context, 0, [&]() {
+        std::lock_guard<std::mutex> guard(context->lock);
+        context->progress_callback = callback;
+        context->progress_user_data = user_data;
+        context->progress_min_seconds = min_seconds;
+        return 0;
+    });
+}
+
+int workout_routine_set_cost_weight(WorkoutRoutineContext* context, const char* key, double value) noexcept {
+    return guarded(context, -1, [&]() {
+        std::lock_guard<std::mutex> guard(context->lock);
+        if (!key || !set_cost_weight(context->weights, key, value)) {
+            context->error = "invalid cost weight " + std::string(key ? key : "(null)");
+            return -1;
+        }
+        context->library.reset();  // Its day scores were built with the old weights
+        context->error.clear();
+        return 0;
+    });
+}
+
+void workout_routine_set_log_callback(WorkoutRoutineContext* context, WorkoutLogCallback callback, void* user_data) noexcept {
+    guarded(context, 0, [&]() {
+        std::lock_guard<std::mutex> guard(context->lock);
+        context->log_callback = callback;
+        context->log_user_data = user_data;
+        return 0;
+    });
+}
+
+void workout_routine_set_quiet(WorkoutRoutineContext* context, int quiet) noexcept {
+    guarded(context, 0, [&]() {
+        std::lock_guard<std::mutex> guard(context->lock);
+        context->quiet = quiet != 0;
+        return 0;
+    });
+}
+
+double workout_routine_cost(WorkoutRoutineContext* context) noexcept {
+    return guarded(context, -1.0, [&]() {
+        std::lock_guard<std::mutex> guard(context->lock);
+        return context->cost;
+    });
+}
+
+int workout_routine_violation_count(WorkoutRoutineContext* context) noexcept {
+    return guarded(context, -1, [&]() {
+        std::lock_guard<std::mutex> guard(context->lock);
+        return context->violations;
+    });
+}
+
+const char* workout_routine_last_error(WorkoutRoutineContext* context) noexcept {
+    return guarded(context, "", [&]() {
+        std::lock_guard<std::mutex> guard(context->lock);
+        return context->error.c_str();
+    });
+}
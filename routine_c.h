@@ -0,0 +1,89 @@
+#ifndef ROUTINE_C_H
+#define ROUTINE_C_H
+
+// C ABI over the routine optimizers for embedding in services. A context holds one member's
+// profile, the day-template library built for it and the last optimized routine. Calls on one
+// context are serialized by its own lock; separate contexts can be used from separate threads
+// at the same time. Strings returned by a context stay valid until its next optimize, profile
+// change or destroy. The annealing and genetic engines log progress to stdout unless the context
+// is quiet or has a log callback. No exception
+// crosses the ABI: a call that fails internally (out of memory included) records
+// workout_routine_last_error and returns -1 (-1.0 for the cost; create returns NULL).
+#ifdef __cplusplus
+extern "C" {
+#define WORKOUT_NOEXCEPT noexcept
+#else
+#define WORKOUT_NOEXCEPT
+#endif
+
+#define WORKOUT_ROUTINE_API_VERSION 4
+
+typedef struct WorkoutRoutineContext WorkoutRoutineContext;
+
+enum {
+    WORKOUT_ENGINE_TEMPLATES = 0,  // Day-template search (fastest, best cost)
+    WORKOUT_ENGINE_ANNEALING = 1,  // Simulated annealing
+    WORKOUT_ENGINE_GENETIC = 2     // Genetic algorithm with day-level crossover
+};
+
+enum {
+    WORKOUT_PROFILE_CSV = 0,
+    WORKOUT_PROFILE_JSONL = 1
+};
+
+// One exercise of an optimized routine; day is 0-based
+typedef struct {
+    int day;
+    const char* exercise;
+    int sets;
+} WorkoutRoutineEntry;
+
+// One progress report; entries point at the best routine so far and are only valid during the
+// callback
+typedef struct {
+    long iteration;
+    double best_cost;
+    int improved;
+    int final;
+    const WorkoutRoutineEntry* entries;
+    int entry_count;
+} WorkoutProgress;
+
+typedef void (*WorkoutProgressCallback)(const WorkoutProgress* progress, void* user_data);
+typedef void (*WorkoutLogCallback)(const char* line, void* user_data);
+
+int workout_routine_api_version(void) WORKOUT_NOEXCEPT;
+WorkoutRoutineContext* workout_routine_create(void) WORKOUT_NOEXCEPT;
+void workout_routine_destroy(WorkoutRoutineContext* context) WORKOUT_NOEXCEPT;
+// Replaces the context's profile with the first member in a CSV or JSONL profile document;
+// returns 0, or -1 with workout_routine_last_error set
+int workout_routine_set_profile(WorkoutRoutineContext* context, const char* text, int format) WORKOUT_NOEXCEPT;
+void workout_routine_reset_profile(WorkoutRoutineContext* context) WORKOUT_NOEXCEPT;
+// Optimizes a routine for the current profile; returns the number of entries, or -1 with
+// workout_routine_last_error set
+int workout_routine_optimize(WorkoutRoutineContext* context, int engine, unsigned int seed) WORKOUT_NOEXCEPT;
+// Copies up to capacity entries of the last routine into entries; returns the total entry count
+int workout_routine_entries(WorkoutRoutineContext* context, WorkoutRoutineEntry* entries, int capacity) WORKOUT_NOEXCEPT;
+// Streams progress from the annealing and genetic engines: each new best and every 1000
+// iterations, at most once per min_seconds. The callback runs on the optimizing thread with the
+// context locked, so it must not call back into the same context. NULL removes it.
+void workout_routine_set_progress_callback(WorkoutRoutineContext* context, WorkoutProgressCallback callback, void* user_data, double min_seconds) WORKOUT_NOEXCEPT;
+// Sets one of the context's penalty weights by cost_weights key (see cost_weights.cpp). Each
+// context starts from the built-in weights; a profile's penalties apply on top of the weights
+// in effect when the profile is set.
+// Returns 0, or -1 with workout_routine_last_error set.
+int workout_routine_set_cost_weight(WorkoutRoutineContext* context, const char* key, double value) WORKOUT_NOEXCEPT;
+// Sends the engines' log lines (without the newline) to callback on the optimizing thread instead
+// of stdout; NULL restores stdout
+void workout_routine_set_log_callback(WorkoutRoutineContext* context, WorkoutLogCallback callback, void* user_data) WORKOUT_NOEXCEPT;
+// Nonzero silences the engines' log entirely, callback included
+void workout_routine_set_quiet(WorkoutRoutineContext* context, int quiet) WORKOUT_NOEXCEPT;
+double workout_routine_cost(WorkoutRoutineContext* context) WORKOUT_NOEXCEPT;
+int workout_routine_violation_count(WorkoutRoutineContext* context) WORKOUT_NOEXCEPT;
+const char* workout_routine_last_error(WorkoutRoutineContext* context) WORKOUT_NOEXCEPT;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ROUTINE_C_H
@@ -0,0 +1,155 @@
+#include "set_allocation.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+// Upper limit on sweeps over the week; each sweep strictly lowers the cost, so this only
+// guards against floating-point ties cycling
+static const int MAX_SWEEPS = 50;
+
+// Improvements and time overruns smaller than this are treated as ties
+static const double MIN_IMPROVEMENT = 1e-9;
+
+// Function to score one muscle's weekly volume
+static double muscle_cost(const SetAllocationProblem& problem, size_t m, double vol) {
+    double deficit = problem.targets[m] - vol;
+    if (deficit > 0) return problem.deficit_weights[m] * deficit * deficit;
+    double excess = vol - problem.upper_bounds[m];
+    return excess > 0 ? problem.excess_weights[m] * excess * excess : 0.0;
+}
+
+// Function to score the day times: overtime plus the spread around the weekly average
+static double time_cost(const SetAllocationProblem& problem, const vector<double>& day_times) {
+    double cost = 0.0;
+    double avg_time = 0.0;
+    for (double time : day_times) avg_time += time;
+    avg_time /= day_times.size();
+    for (double time : day_times) {
+        if (time > problem.max_day_time) cost += problem.overtime_weight * (time - problem.max_day_time);
+        double diff = time - avg_time;
+        cost += (diff > 0 ? problem.time_variance_over : problem.time_variance_under) * diff * diff;
+    }
+    return cost;
+}
+
+// Function to add an item's volume for the given number of sets
+static void add_item(const SetAllocationProblem& problem, vector<double>& volume, size_t item, double sets) {
+    const double* per_set = &problem.item_volumes[item * problem.muscles];
+    for (size_t m = 0; m < problem.muscles; ++m) volume[m] += per_set[m] * sets;
+}
+
+// Function to compute the weekly volume and day times of an allocation
+static void totals(const SetAllocationProblem& problem, const vector<int>& sets, vector<double>& volume, vector<double>& day_times) {
+    volume.assign(problem.muscles, 0.0);
+    day_times.assign(problem.day_items.size(), 0.0);
+    for (size_t day = 0; day < problem.day_items.size(); ++day) {
+        day_times[day] = problem.day_fixed_times[day];
+        for (size_t item : problem.day_items[day]) {
+            add_item(problem, volume, item, sets[item]);
+            day_times[day] += problem.item_times[item] * sets[item];
+        }
+    }
+}
+
+// Function to score an allocation: the volume terms plus the time terms
+double set_allocation_cost(const SetAllocationProblem& problem, const vector<int>& sets) {
+    vector<double> volume;
+    vector<double> day_times;
+    totals(problem, sets, volume, day_times);
+    double cost = time_cost(problem, day_times);
+    for (size_t m = 0; m < problem.muscles; ++m) cost += muscle_cost(problem, m, volume[m]);
+    return cost;
+}
+
+// Function to choose the set counts: exact per day, coordinate descent across days. Each day's
+// set vector is solved exactly by enumerating every vector in [min_sets, max_sets]^items with
+// the other days held fixed, and days are re-solved until a full sweep changes nothing, so the
+// result is a per-day optimum, not necessarily the joint optimum over the week. Only the muscles a day touches are rescored per
+// vector. Counts outside the bounds, and days over a hard time limit, are always replaced.
+// When out_of_time is given it is asked before each day, and solving stops with the days done
+// so far once it returns true. Returns the final cost.
+double solve_set_allocation(const SetAllocationProblem& problem, vector<int>& sets, const function<bool()>& out_of_time) {
+    vector<double> volume;
+    vector<double> day_times;
+    totals(problem, sets, volume, day_times);
+    int choices = problem.max_sets - problem.min_sets + 1;
+
+    bool changed = true;
+    for (int sweep = 0; changed && sweep < MAX_SWEEPS; ++sweep) {
+        changed = false;
+        for (size_t day = 0; day < problem.day_items.size(); ++day) {
+            const vector<size_t>& items = problem.day_items[day];
+            if (items.empty()) continue;
+            if (out_of_time && out_of_time()) return set_allocation_cost(problem, sets);
+
+            // Muscles the day's items touch; the rest score the same for every vector
+            vector<size_t> touched;
+            for (size_t m = 0; m < problem.muscles; ++m) {
+                for (size_t item : items) {
+                    if (problem.item_volumes[item * problem.muscles + m] != 0.0) {
+                        touched.push_back(m);
+                        break;
+                    }
+                }
+            }
+            bool in_bounds = true;
+            for (size_t item : items) {
+                add_item(problem, volume, item, -sets[item]);
+                in_bounds = in_bounds && sets[item] >= problem.min_sets && sets[item] <= problem.max_sets;
+            }
+            // Longest the day may run under a hard limit: a day that overruns even at minimum
+            // sets may only take its shortest vector
+            double time_limit = problem.day_fixed_times[day];
+            for (size_t item : items) time_limit += problem.item_times[item] * problem.min_sets;
+            time_limit = problem.hard_time_limit ? max(time_limit, problem.max_day_time) : numeric_limits<double>::max();
+
+            vector<double> day_volume(touched.size());
+            auto day_cost = [&](const vector<int>& day_sets) {
+                double time = problem.day_fixed_times[day];
+                for (size_t t = 0; t < touched.size(); ++t) day_volume[t] = volume[touched[t]];
+                for (size_t i = 0; i < items.size(); ++i) {
+                    const double* per_set = &problem.item_volumes[items[i] * problem.muscles];
+                    for (size_t t = 0; t < touched.size(); ++t) day_volume[t] += per_set[touched[t]] * day_sets[i];
+                    time += problem.item_times[items[i]] * day_sets[i];
+                }
+                if (time > time_limit + MIN_IMPROVEMENT) return numeric_limits<double>::max();
+                double saved = day_times[day];
+                day_times[day] = time;
+                double cost = time_cost(problem, day_times);
+                day_times[day] = saved;
+                for (size_t t = 0; t < touched.size(); ++t) cost += muscle_cost(problem, touched[t], day_volume[t]);
+                return cost;
+            };
+
+            vector<int> current(items.size());
+            for (size_t i = 0; i < items.size(); ++i) current[i] = sets[items[i]];
+            double best_cost = in_bounds ? day_cost(current) : numeric_limits<double>::max();
+            bool best_feasible = best_cost < numeric_limits<double>::max();
+            vector<int> best = current;
+            vector<int> candidate(items.size(), problem.min_sets);
+            while (true) {
+                double cost = day_cost(candidate);
+                if (cost < numeric_limits<double>::max() && (!best_feasible || cost < best_cost - MIN_IMPROVEMENT)) {
+                    best_cost = cost;
+                    best = candidate;
+                    best_feasible = true;
+                }
+                // Odometer step over the day's set vectors
+                size_t i = 0;
+                while (i < items.size() && candidate[i] == problem.min_sets + choices - 1) candidate[i++] = problem.min_sets;
+                if (i == items.size()) break;
+                ++candidate[i];
+            }
+
+            day_times[day] = problem.day_fixed_times[day];
+            for (size_t i = 0; i < items.size(); ++i) {
+                if (sets[items[i]] != best[i]) changed = true;
+                sets[items[i]] = best[i];
+                add_item(problem, volume, items[i], best[i]);
+                day_times[day] += problem.item_times[items[i]] * best[i];
+            }
+        }
+    }
+    return set_allocation_cost(problem, sets);
+}
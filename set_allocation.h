@@ -0,0 +1,33 @@
+#ifndef SET_ALLOCATION_H
+#define SET_ALLOCATION_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// Set-allocation subproblem shared by both generators: the exercises (or structures) on each
+// day are fixed and only their set counts are free. Items are numbered across the week and
+// described densely, so the solver depends on neither catalog.
+struct SetAllocationProblem {
+    size_t muscles = 0;
+    std::vector<double> targets;              // per muscle
+    std::vector<double> upper_bounds;
+    std::vector<double> deficit_weights;      // per squared set below target
+    std::vector<double> excess_weights;       // per squared set above the upper bound
+    std::vector<std::vector<size_t>> day_items;
+    std::vector<double> item_volumes;         // per-set volume, [item * muscles + muscle]
+    std::vector<double> item_times;           // minutes per set
+    std::vector<double> day_fixed_times;      // minutes a day takes regardless of sets (changeovers)
+    int min_sets = 2;
+    int max_sets = 5;
+    double max_day_time = 50.0;
+    bool hard_time_limit = true;              // Days may not exceed max_day_time (or their minimum time, if longer)
+    double overtime_weight = 0.0;             // per minute a day runs above max_day_time
+    double time_variance_over = 0.0;          // per squared minute a day runs above the average
+    double time_variance_under = 0.0;         // per squared minute a day runs below the average
+};
+
+double set_allocation_cost(const SetAllocationProblem& problem, const std::vector<int>& sets);
+double solve_set_allocation(const SetAllocationProblem& problem, std::vector<int>& sets, const std::function<bool()>& out_of_time = {});
+
+#endif // SET_ALLOCATION_H
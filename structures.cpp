@@ -0,0 +1,137 @@
+#include "structures.h"
+#include "utils.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+// Largest structure the time model knows about (tri-set)
+const int MAX_STRUCTURE_SIZE = 3;
+// Days with more groupable exercises than this fall back to straight sets
+const size_t MAX_GROUPING_EXERCISES = 12;
+
+// Function to check if two exercises share a primary muscle (synergists cannot be paired)
+static bool shares_primary(const Exercise& a, const Exercise& b) {
+    for (const auto& muscle : a.primary) {
+        if (find(b.primary.begin(), b.primary.end(), muscle) != b.primary.end()) return true;
+    }
+    return false;
+}
+
+// Function to build the compatibility matrix from the pair list, dropping synergistic pairs
+CompatibilityMatrix build_compatibility_matrix(const vector<Exercise>& exercises, const vector<pair<string, string>>& pairs) {
+    CompatibilityMatrix matrix;
+    for (size_t i = 0; i < exercises.size(); ++i) {
+        matrix.index[exercises[i].name] = static_cast<int>(i);
+    }
+    matrix.words = (exercises.size() + 63) / 64;
+    matrix.bits.assign(exercises.size() * matrix.words, 0);
+    for (const auto& [a, b] : pairs) {
+        auto it_a = matrix.index.find(a);
+        auto it_b = matrix.index.find(b);
+        if (it_a == matrix.index.end() || it_b == matrix.index.end()) continue;
+        int i = it_a->second;
+        int j = it_b->second;
+        if (i == j || shares_primary(exercises[i], exercises[j])) continue;
+        matrix.bits[i * matrix.words + j / 64] |= uint64_t(1) << (j % 64);
+        matrix.bits[j * matrix.words + i / 64] |= uint64_t(1) << (i % 64);
+    }
+    return matrix;
+}
+
+// Function to check if two exercises can be performed in the same structure
+bool are_compatible(const CompatibilityMatrix& matrix, const string& a, const string& b) {
+    auto it_a = matrix.index.find(a);
+    auto it_b = matrix.index.find(b);
+    if (it_a == matrix.index.end() || it_b == matrix.index.end()) return false;
+    int j = it_b->second;
+    return (matrix.bits[it_a->second * matrix.words + j / 64] >> (j % 64)) & 1;
+}
+
+// Branch and bound over groupings of the remaining exercises, pruning any branch whose
+// time (plus the tri-set rate for everything still unassigned) cannot beat the best so far
+static void search_groupings(
+    const vector<uint32_t>& local_compat,
+    uint32_t remaining,
+    int sets,
+    double time_so_far,
+    vector<uint32_t>& groups,
+    double& best_time,
+    vector<uint32_t>& best_groups
+) {
+    if (remaining == 0) {
+        if (time_so_far < best_time) {
+            best_time = time_so_far;
+            best_groups = groups;
+        }
+        return;
+    }
+    double per_exercise_floor = structure_time(MAX_STRUCTURE_SIZE, sets) / MAX_STRUCTURE_SIZE;
+    int unassigned = __builtin_popcount(remaining);
+    if (time_so_far + unassigned * per_exercise_floor >= best_time) return;
+
+    int i = __builtin_ctz(remaining);
+    uint32_t rest = remaining & ~(1u << i);
+    uint32_t partners = local_compat[i] & rest;
+
+    // Tri-sets first so the cheapest groupings set the bound early
+    for (uint32_t p = partners; p; p &= p - 1) {
+        int j = __builtin_ctz(p);
+        uint32_t thirds = partners & local_compat[j] & ~((2u << j) - 1);
+        for (uint32_t q = thirds; q; q &= q - 1) {
+            int k = __builtin_ctz(q);
+            groups.push_back((1u << i) | (1u << j) | (1u << k));
+            search_groupings(local_compat, rest & ~(1u << j) & ~(1u << k), sets,
+                             time_so_far + structure_time(3, sets), groups, best_time, best_groups);
+            groups.pop_back();
+        }
+    }
+    for (uint32_t p = partners; p; p &= p - 1) {
+        int j = __builtin_ctz(p);
+        groups.push_back((1u << i) | (1u << j));
+        search_groupings(local_compat, rest & ~(1u << j), sets,
+                         time_so_far + structure_time(2, sets), groups, best_time, best_groups);
+        groups.pop_back();
+    }
+    groups.push_back(1u << i);
+    search_groupings(local_compat, rest, sets, time_so_far + structure_time(1, sets), groups, best_time, best_groups);
+    groups.pop_back();
+}
+
+// Function to group a day's exercises into straight sets, supersets and tri-sets.
+// The first exercise (the compound) stays a straight set; the rest are grouped to
+// minimize the day's time at the given set count.
+vector<Structure> build_day_structures(const vector<string>& day_exercises, const CompatibilityMatrix& matrix, int sets) {
+    vector<Structure> structures;
+    if (day_exercises.empty()) return structures;
+    structures.push_back({{day_exercises[0]}, sets});
+
+    vector<string> rest(day_exercises.begin() + 1, day_exercises.end());
+    if (rest.size() > MAX_GROUPING_EXERCISES) {
+        for (const auto& exercise : rest) structures.push_back({{exercise}, sets});
+        return structures;
+    }
+
+    vector<uint32_t> local_compat(rest.size(), 0);
+    for (size_t i = 0; i < rest.size(); ++i) {
+        for (size_t j = i + 1; j < rest.size(); ++j) {
+            if (are_compatible(matrix, rest[i], rest[j])) {
+                local_compat[i] |= 1u << j;
+                local_compat[j] |= 1u << i;
+            }
+        }
+    }
+
+    uint32_t all = (1u << rest.size()) - 1;
+    vector<uint32_t> groups;
+    vector<uint32_t> best_groups;
+    double best_time = numeric_limits<double>::max();
+    search_groupings(local_compat, all, sets, 0.0, groups, best_time, best_groups);
+
+    for (uint32_t group : best_groups) {
+        vector<string> members;
+        for (uint32_t g = group; g; g &= g - 1) members.push_back(rest[__builtin_ctz(g)]);
+        structures.push_back({members, sets});
+    }
+    return structures;
+}
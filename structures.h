@@ -0,0 +1,21 @@
+#ifndef STRUCTURES_H
+#define STRUCTURES_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "exercise_definitions.h"
+
+// Bitset compatibility matrix: bit j of row i is set when exercises i and j can share a structure
+struct CompatibilityMatrix {
+    unordered_map<string, int> index;
+    size_t words;
+    vector<uint64_t> bits;
+};
+
+CompatibilityMatrix build_compatibility_matrix(const vector<Exercise>& exercises, const vector<pair<string, string>>& pairs);
+bool are_compatible(const CompatibilityMatrix& matrix, const string& a, const string& b);
+vector<Structure> build_day_structures(const vector<string>& day_exercises, const CompatibilityMatrix& matrix, int sets);
+
+#endif // STRUCTURES_H
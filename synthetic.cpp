@@ -0,0 +1,97 @@
+#include "synthetic.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+// Function to format a zero-padded synthetic name, e.g. "Muscle 007"
+static string synthetic_name(const string& prefix, int index, int count) {
+    int width = to_string(count).size();
+    char digits[16];
+    snprintf(digits, sizeof(digits), "%0*d", width, index);
+    return prefix + " " + digits;
+}
+
+// Function to draw `count` distinct muscles not already in `taken`
+static vector<string> draw_muscles(const vector<string>& muscles, int count, vector<string>& taken, mt19937& gen) {
+    uniform_int_distribution<> pick(0, static_cast<int>(muscles.size()) - 1);
+    vector<string> drawn;
+    count = min(count, static_cast<int>(muscles.size() - taken.size()));
+    while (static_cast<int>(drawn.size()) < count) {
+        const string& muscle = muscles[pick(gen)];
+        if (find(taken.begin(), taken.end(), muscle) != taken.end()) continue;
+        taken.push_back(muscle);
+        drawn.push_back(muscle);
+    }
+    return drawn;
+}
+
+// Function to build a synthetic catalog, targets, recovery table and members. Exercises draw
+// their primary muscles uniformly and their secondary and isometric counts from Poisson
+// distributions with the given densities. Targets are scaled down when the catalog's average set
+// could not meet them within the week's set capacity, so large workloads stay satisfiable on
+// average rather than being all deficit.
+SyntheticWorkload make_synthetic_workload(const SyntheticOptions& options) {
+    mt19937 gen(options.seed);
+    SyntheticWorkload workload;
+    vector<string> muscles;
+    for (int m = 1; m <= options.muscles; ++m) muscles.push_back(synthetic_name("Muscle", m, options.muscles));
+    int leg_muscles = static_cast<int>(options.leg_fraction * options.muscles + 0.5);
+
+    uniform_real_distribution<> unit(0, 1);
+    poisson_distribution<> secondary_count(options.secondary_density);
+    poisson_distribution<> isometric_count(options.isometric_density);
+    double volume_per_set = 0.0;
+    for (int i = 1; i <= options.exercises; ++i) {
+        Exercise ex;
+        ex.name = synthetic_name("Synthetic", i, options.exercises);
+        ex.is_compound = unit(gen) < options.compound_fraction;
+        vector<string> taken;
+        ex.primary = draw_muscles(muscles, ex.is_compound ? 2 : 1, taken, gen);
+        ex.secondary = draw_muscles(muscles, secondary_count(gen), taken, gen);
+        ex.isometric = draw_muscles(muscles, isometric_count(gen), taken, gen);
+        ex.is_leg = any_of(ex.primary.begin(), ex.primary.end(), [&](const string& muscle) {
+            return find(muscles.begin(), muscles.begin() + leg_muscles, muscle) != muscles.begin() + leg_muscles;
+        });
+        volume_per_set += ex.primary.size() + 0.5 * ex.secondary.size() + 0.25 * ex.isometric.size();
+        workload.exercises.push_back(ex);
+    }
+    volume_per_set /= max(1, options.exercises);
+
+    // Volume the week can hold at full time, against the volume the unscaled targets ask for
+    double capacity = TOTAL_DAYS * MAX_TIME_PER_DAY / TIME_PER_SET * volume_per_set;
+    double demand = options.muscles * (options.target_min + options.target_max) / 2.0;
+    double scale = demand > 0.0 ? min(1.0, capacity / demand) : 1.0;
+
+    discrete_distribution<> recovery(options.recovery_weights.begin(), options.recovery_weights.end());
+    uniform_real_distribution<> target(options.target_min, options.target_max);
+    UserProfile base;
+    base.user_id = options.name;
+    for (const auto& muscle : muscles) {
+        double t = target(gen) * scale;
+        base.mav_targets[muscle] = {t, t + options.upper_spread * scale};
+        base.overrides.recovery_days[muscle] = recovery(gen) + 1;
+    }
+    // No synthetic catalog has a Leg Curl, so the inclusion penalty would only add a constant
+    base.overrides.weights = cost_weights;
+    base.overrides.weights->inclusion = 0.0;
+    workload.profiles.push_back(base);
+
+    uniform_real_distribution<> jitter(1.0 - options.target_jitter, 1.0 + options.target_jitter);
+    for (int p = 1; p <= options.profiles; ++p) {
+        UserProfile profile = base;
+        profile.user_id = options.name + "_m" + to_string(p);
+        for (const auto& muscle : muscles) {
+            MuscleGroup& group = profile.mav_targets[muscle];
+            double spread = group.upper_bound - group.target;
+            group.target *= jitter(gen);
+            group.upper_bound = group.target + spread;
+            if (unit(gen) < options.recovery_change_rate) profile.overrides.recovery_days[muscle] = recovery(gen) + 1;
+        }
+        for (const auto& ex : workload.exercises) {
+            if (!ex.is_compound && unit(gen) < options.exclusion_rate) profile.excluded_exercises.insert(ex.name);
+        }
+        workload.profiles.push_back(profile);
+    }
+    return workload;
+}
@@ -0,0 +1,40 @@
+#ifndef SYNTHETIC_H
+#define SYNTHETIC_H
+
+#include <string>
+#include <vector>
+#include "optimizer.h"
+#include "profile.h"
+
+// Struct to hold the shape of a synthetic workload. The same options and seed always give the
+// same workload (with the same standard library).
+struct SyntheticOptions {
+    int exercises = 100;
+    int muscles = 20;
+    unsigned int seed = 1;
+    double compound_fraction = 0.25;                        // compounds work 2 primary muscles, isolations 1
+    double secondary_density = 0.8;                         // mean secondary muscles per exercise
+    double isometric_density = 0.1;                         // mean isometric muscles per exercise
+    double leg_fraction = 0.2;                              // share of muscles that make an exercise a leg exercise
+    std::vector<double> recovery_weights = {0.3, 0.5, 0.2}; // relative odds of 1, 2, 3... recovery days
+    double target_min = 6.0;                                // weekly target sets, before capacity scaling
+    double target_max = 14.0;
+    double upper_spread = 6.0;                              // upper bound = target + spread
+    std::string name = "synthetic";                         // base member's id; others are <name>_m1, <name>_m2...
+    int profiles = 0;                                       // members besides the base one
+    double target_jitter = 0.2;                             // members scale each target by up to +/- this
+    double recovery_change_rate = 0.2;                      // chance a member redraws a muscle's recovery
+    double exclusion_rate = 0.05;                           // chance a member excludes an isolation exercise
+};
+
+// Struct to hold a synthetic catalog and its members. profiles[0] is the base member: the
+// synthetic targets and recovery table with no exclusions, and the active cost weights with the
+// Leg Curl inclusion penalty off. Every member carries those weights.
+struct SyntheticWorkload {
+    std::vector<Exercise> exercises;
+    std::vector<UserProfile> profiles;
+};
+
+SyntheticWorkload make_synthetic_workload(const SyntheticOptions& options);
+
+#endif // SYNTHETIC_H
@@ -0,0 +1,117 @@
+#include "telemetry.h"
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+// Names of the perturb_routine moves, indexed by action
+static const char* const MOVE_NAMES[NUM_MOVE_TYPES] = {
+    "remove", "replace", "add", "swap_days", "adjust_sets", "swap_within_day"
+};
+
+// Function to name a move type
+const char* move_type_name(int move) {
+    if (move < 0 || move >= NUM_MOVE_TYPES) return "unknown";
+    return MOVE_NAMES[move];
+}
+
+// Function to record the outcome of one proposal
+void record_move(OptimizerTelemetry& telemetry, int move, bool accepted, bool improved, bool infeasible) {
+    ++telemetry.iterations;
+    if (infeasible) ++telemetry.infeasible;
+    if (move < 0 || move >= NUM_MOVE_TYPES) return;
+    MoveStats& stats = telemetry.moves[move];
+    ++stats.attempts;
+    if (accepted) ++stats.acceptances;
+    if (improved) ++stats.improvements;
+    if (infeasible) ++stats.infeasible;
+}
+
+// Function to record a proposal whose move did not apply (no evaluation was spent on it)
+void record_no_op(OptimizerTelemetry& telemetry, int move) {
+    ++telemetry.iterations;
+    if (move < 0 || move >= NUM_MOVE_TYPES) return;
+    ++telemetry.moves[move].attempts;
+    ++telemetry.moves[move].no_ops;
+}
+
+// Function to record a proposal rejected by the cost lower bound before full costing
+void record_screened(OptimizerTelemetry& telemetry, int move) {
+    ++telemetry.iterations;
+    if (move < 0 || move >= NUM_MOVE_TYPES) return;
+    ++telemetry.moves[move].attempts;
+    ++telemetry.moves[move].screened;
+}
+
+// Function to sample the cost trajectory on the first call and then each time the iteration
+// reaches or passes the next multiple of sample_interval (engines that advance several
+// iterations per step land on the boundary only by chance)
+void record_sample(OptimizerTelemetry& telemetry, int iteration, double temperature, double current_cost, double best_cost) {
+    if (telemetry.sample_interval <= 0) return;
+    if (!telemetry.trajectory.empty() && iteration / telemetry.sample_interval <= telemetry.trajectory.back().iteration / telemetry.sample_interval) return;
+    telemetry.trajectory.push_back({iteration, temperature, current_cost, best_cost});
+}
+
+// Function to convert a clock interval to seconds
+double seconds_between(TelemetryClock::time_point start, TelemetryClock::time_point end) {
+    return chrono::duration<double>(end - start).count();
+}
+
+// Function to export telemetry as a single JSON document
+bool write_telemetry_json(const OptimizerTelemetry& telemetry, const string& filename) {
+    ofstream out(filename);
+    if (!out) {
+        cerr << "Error opening file " << filename << endl;
+        return false;
+    }
+    out.precision(10);
+    out << "{\n";
+    out << "  \"iterations\": " << telemetry.iterations << ",\n";
+    out << "  \"infeasible\": " << telemetry.infeasible << ",\n";
+    out << "  \"infeasible_rate\": " << (telemetry.iterations ? static_cast<double>(telemetry.infeasible) / telemetry.iterations : 0.0) << ",\n";
+    out << "  \"cost_table_hits\": " << telemetry.cost_table_hits << ",\n";
+    out << "  \"seconds\": {\"perturb\": " << telemetry.perturb_seconds
+        << ", \"cost\": " << telemetry.cost_seconds
+        << ", \"accept\": " << telemetry.accept_seconds << "},\n";
+    out << "  \"moves\": [\n";
+    for (int move = 0; move < NUM_MOVE_TYPES; ++move) {
+        const MoveStats& stats = telemetry.moves[move];
+        out << "    {\"name\": \"" << move_type_name(move) << "\", \"attempts\": " << stats.attempts
+            << ", \"acceptances\": " << stats.acceptances << ", \"improvements\": " << stats.improvements
+            << ", \"infeasible\": " << stats.infeasible << ", \"no_ops\": " << stats.no_ops << ", \"screened\": " << stats.screened << "}" << (move + 1 < NUM_MOVE_TYPES ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    out << "  \"sample_interval\": " << telemetry.sample_interval << ",\n";
+    out << "  \"trajectory\": [\n";
+    for (size_t i = 0; i < telemetry.trajectory.size(); ++i) {
+        const TrajectorySample& sample = telemetry.trajectory[i];
+        out << "    {\"iteration\": " << sample.iteration << ", \"temperature\": " << sample.temperature
+            << ", \"current_cost\": " << sample.current_cost << ", \"best_cost\": " << sample.best_cost
+            << "}" << (i + 1 < telemetry.trajectory.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+    return true;
+}
+
+// Function to export telemetry as two CSV tables (per-move counters and cost trajectory)
+bool write_telemetry_csv(const OptimizerTelemetry& telemetry, const string& moves_filename, const string& trajectory_filename) {
+    ofstream moves(moves_filename);
+    ofstream trajectory(trajectory_filename);
+    if (!moves || !trajectory) {
+        cerr << "Error opening telemetry CSV files" << endl;
+        return false;
+    }
+    moves << "move,attempts,acceptances,improvements,infeasible,no_ops,screened\n";
+    for (int move = 0; move < NUM_MOVE_TYPES; ++move) {
+        const MoveStats& stats = telemetry.moves[move];
+        moves << move_type_name(move) << "," << stats.attempts << "," << stats.acceptances << ","
+              << stats.improvements << "," << stats.infeasible << "," << stats.no_ops << "," << stats.screened << "\n";
+    }
+    trajectory.precision(10);
+    trajectory << "iteration,temperature,current_cost,best_cost\n";
+    for (const auto& sample : telemetry.trajectory) {
+        trajectory << sample.iteration << "," << sample.temperature << "," << sample.current_cost << "," << sample.best_cost << "\n";
+    }
+    return true;
+}
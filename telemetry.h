@@ -0,0 +1,53 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+// Number of move types in perturb_routine (remove, replace, add, swap days, adjust sets, swap within day)
+const int NUM_MOVE_TYPES = 6;
+
+// Struct to hold counters for one move type
+struct MoveStats {
+    long attempts = 0;
+    long acceptances = 0;
+    long improvements = 0;
+    long infeasible = 0;
+    long no_ops = 0;
+    long screened = 0;
+};
+
+// Struct to hold one sampled point of the cost trajectory
+struct TrajectorySample {
+    int iteration;
+    double temperature;
+    double current_cost;
+    double best_cost;
+};
+
+// Struct to hold instrumentation for one optimizer run
+struct OptimizerTelemetry {
+    MoveStats moves[NUM_MOVE_TYPES];
+    long iterations = 0;
+    long infeasible = 0;
+    long cost_table_hits = 0;    // Proposals costed by a transposition table lookup
+    double perturb_seconds = 0.0;
+    double cost_seconds = 0.0;
+    double accept_seconds = 0.0;
+    int sample_interval = 100;
+    std::vector<TrajectorySample> trajectory;
+};
+
+using TelemetryClock = std::chrono::steady_clock;
+
+const char* move_type_name(int move);
+void record_move(OptimizerTelemetry& telemetry, int move, bool accepted, bool improved, bool infeasible);
+void record_no_op(OptimizerTelemetry& telemetry, int move);
+void record_screened(OptimizerTelemetry& telemetry, int move);
+void record_sample(OptimizerTelemetry& telemetry, int iteration, double temperature, double current_cost, double best_cost);
+double seconds_between(TelemetryClock::time_point start, TelemetryClock::time_point end);
+bool write_telemetry_json(const OptimizerTelemetry& telemetry, const std::string& filename);
+bool write_telemetry_csv(const OptimizerTelemetry& telemetry, const std::string& moves_filename, const std::string& trajectory_filename);
+
+#endif // TELEMETRY_H
@@ -0,0 +1,44 @@
+#include "transposition.h"
+#include <cstring>
+#include <functional>
+
+using namespace std;
+
+// Function to scramble 64 bits (the splitmix64 finalizer)
+static uint64_t mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+// Function to compute the Zobrist key of one routine entry
+uint64_t zobrist_key(int day, size_t slot, const string& exercise, int sets) {
+    uint64_t position = (static_cast<uint64_t>(day) << 40) ^ (static_cast<uint64_t>(slot) << 20) ^ static_cast<uint32_t>(sets);
+    return mix(hash<string>()(exercise) ^ mix(position));
+}
+
+// Function to allocate an empty table of 2^bits entries
+shared_ptr<CostTable> make_cost_table(int bits) {
+    auto table = make_shared<CostTable>();
+    table->entries.reset(new CostTableEntry[size_t(1) << bits]);
+    table->mask = (uint64_t(1) << bits) - 1;
+    return table;
+}
+
+// Function to look up a routine's cost; false when the hash is not in the table
+bool probe_cost(const CostTable& table, uint64_t hash, double& cost) {
+    const CostTableEntry& entry = table.entries[hash & table.mask];
+    uint64_t bits = entry.bits.load(memory_order_relaxed);
+    if ((entry.check.load(memory_order_relaxed) ^ bits) != hash) return false;
+    memcpy(&cost, &bits, sizeof(cost));
+    return true;
+}
+
+// Function to record a routine's cost, replacing whatever held its slot
+void store_cost(CostTable& table, uint64_t hash, double cost) {
+    CostTableEntry& entry = table.entries[hash & table.mask];
+    uint64_t bits;
+    memcpy(&bits, &cost, sizeof(bits));
+    entry.check.store(hash ^ bits, memory_order_relaxed);
+    entry.bits.store(bits, memory_order_relaxed);
+}
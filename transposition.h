@@ -0,0 +1,37 @@
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Entries in a cost table are 2^COST_TABLE_BITS (16 bytes each)
+const int COST_TABLE_BITS = 17;
+
+// Zobrist key of one routine entry: `exercise` with `sets` sets in slot `slot` of `day`. A routine's
+// hash is the XOR of its entries' keys, so a changed day is XORed out and its replacement back in.
+// Keys are mixed from the entry itself rather than drawn into a table, so any catalog size,
+// slot count or set count has one.
+uint64_t zobrist_key(int day, std::size_t slot, const std::string& exercise, int sets);
+
+// One slot of a cost table: the cost's bits and the routine hash XORed with them
+struct CostTableEntry {
+    std::atomic<uint64_t> check{~0ull};
+    std::atomic<uint64_t> bits{0};
+};
+
+// Fixed-size table of routine hash -> cost, shared by threads without locks. Stores always
+// replace the slot; an entry torn by a concurrent store fails the XOR check and reads as a miss.
+// Costs depend on the catalog, targets and profile, so a table serves one run.
+struct CostTable {
+    std::unique_ptr<CostTableEntry[]> entries;
+    uint64_t mask = 0;
+};
+
+std::shared_ptr<CostTable> make_cost_table(int bits = COST_TABLE_BITS);
+bool probe_cost(const CostTable& table, uint64_t hash, double& cost);
+void store_cost(CostTable& table, uint64_t hash, double cost);
+
+#endif // TRANSPOSITION_H
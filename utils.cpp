@@ -14,8 +14,20 @@ string join(const vector<string>& vec, const string& delimiter) {
 
 // Function to calculate time for a set structure
 double calculate_time(const vector<string>& structure, int sets) {
-    if (structure.size() == 1) return sets * 120.0 / 60.0;  // Straight set
-    else if (structure.size() == 2) return sets * 195.0 / 60.0;  // Superset
-    else if (structure.size() == 3) return sets * 270.0 / 60.0;  // Tri-set
+    return structure_time(structure.size(), sets);
+}
+
+// Function to calculate time for a structure of the given size
+double structure_time(size_t size, int sets) {
+    if (size == 1) return sets * 120.0 / 60.0;  // Straight set
+    else if (size == 2) return sets * 195.0 / 60.0;  // Superset
+    else if (size == 3) return sets * 270.0 / 60.0;  // Tri-set
     return 0;
+}
+
+// Function to name a structure by its size
+string structure_type_name(size_t size) {
+    if (size == 2) return "Superset";
+    else if (size == 3) return "Tri-Set";
+    return "Straight Set";
 }
\ No newline at end of file
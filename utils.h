@@ -6,5 +6,7 @@
 
 std::string join(const std::vector<std::string>& vec, const std::string& delimiter);
 double calculate_time(const std::vector<std::string>& structure, int sets);
+double structure_time(size_t size, int sets);
+std::string structure_type_name(size_t size);
 
 #endif // UTILS_H
\ No newline at end of file